@@ -241,6 +241,40 @@ cdef extern from "File_Packer.hpp" namespace "fast5":
         size_t al_move_bits
         double rs_total_duration
         double rs_called_duration
+        double rs_read_time
+        double rs_encode_time
+        double rs_check_time
+        double rs_write_time
+        size_t rs_read_bytes
+        size_t rs_write_bytes
+        double ed_read_time
+        double ed_encode_time
+        double ed_check_time
+        double ed_write_time
+        size_t ed_read_bytes
+        size_t ed_write_bytes
+        double fq_read_time
+        double fq_encode_time
+        double fq_check_time
+        double fq_write_time
+        size_t fq_read_bytes
+        size_t fq_write_bytes
+        double ev_read_time
+        double ev_encode_time
+        double ev_check_time
+        double ev_write_time
+        size_t ev_read_bytes
+        size_t ev_write_bytes
+        double al_read_time
+        double al_encode_time
+        double al_check_time
+        double al_write_time
+        size_t al_read_bytes
+        size_t al_write_bytes
+        double open_time
+        double close_time
+        size_t hdf5_read_bytes
+        size_t hdf5_write_bytes
 
     cppclass Cpp_File_Packer "fast5::File_Packer":
 
@@ -249,7 +283,10 @@ cdef extern from "File_Packer.hpp" namespace "fast5":
         Cpp_File_Packer(int, int, int, int, int)
 
         void set_check(bool)
+        void set_check_from_disk(bool)
+        void set_check_async(bool)
         void set_force(bool)
+        void set_in_memory(bool)
         void set_qv_bits(unsigned)
         void set_p_model_state_bits(unsigned)
 
@@ -508,8 +545,14 @@ cdef class File_Packer:
 
     def set_check(self, _check):
         deref(self.thisptr).set_check(_check)
+    def set_check_from_disk(self, _check_from_disk):
+        deref(self.thisptr).set_check_from_disk(_check_from_disk)
+    def set_check_async(self, _check_async):
+        deref(self.thisptr).set_check_async(_check_async)
     def set_force(self, _force):
         deref(self.thisptr).set_force(_force)
+    def set_in_memory(self, _in_memory):
+        deref(self.thisptr).set_in_memory(_in_memory)
     def set_qv_bits(self, _qv_bits):
         deref(self.thisptr).set_qv_bits(_qv_bits)
     def set_p_model_state_bits(self, _p_model_state_bits):
@@ -0,0 +1,248 @@
+//
+// Part of: https://github.com/mateidavid/fast5
+//
+// Copyright (c) 2015-2017 Matei David, Ontario Institute for Cancer Research
+// MIT License
+//
+
+#ifndef __FILE_GENERATOR_HPP
+#define __FILE_GENERATOR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "fast5.hpp"
+
+namespace fast5
+{
+
+/**
+ * Generator of synthetic fast5 files, for benchmarks and for reproducing issues without production data.
+ * Each file holds one read with raw samples, eventdetection events, and a metrichor-style basecall group
+ * with template and complement fastq and events, and a 2D fastq and alignment.
+ * Output is fully determined by the generator parameters, the seed, and the read number: random values
+ * are drawn directly from std::mt19937, whose output is fixed by the standard, so files are identical
+ * across standard library implementations.
+ */
+class File_Generator
+{
+public:
+    File_Generator() :
+        seed(1),
+        num_samples(40000),
+        min_event_length(3),
+        max_event_length(20),
+        max_move(2),
+        noise_stdv(8.0)
+    {}
+
+    void set_seed(unsigned _seed) { seed = _seed; }
+    void set_num_samples(size_t _num_samples) { num_samples = _num_samples; }
+    void set_event_length(unsigned _min_event_length, unsigned _max_event_length)
+    {
+        min_event_length = std::max(_min_event_length, 1u);
+        max_event_length = std::max(_max_event_length, min_event_length);
+    }
+    void set_max_move(unsigned _max_move) { max_move = _max_move; }
+    void set_noise_stdv(double _noise_stdv) { noise_stdv = _noise_stdv; }
+
+    static std::string const & group_name() { static std::string const _group_name = "000"; return _group_name; }
+    static unsigned kmer_size() { return 5; }
+
+    /**
+     * Create a synthetic fast5 file.
+     * @param ofn Output file name; overwritten if it exists.
+     * @param read_number Read number, also used to derive the random stream.
+     */
+    void
+    run(std::string const & ofn, unsigned read_number) const
+    {
+        File f;
+        f.create(ofn, true);
+        generate(f, read_number);
+        f.close();
+    } // run()
+
+    /**
+     * Add the contents of a synthetic read to a fast5 file open for writing.
+     * @param f Destination file.
+     * @param read_number Read number, also used to derive the random stream.
+     */
+    void
+    generate(File & f, unsigned read_number) const
+    {
+        assert(f.is_open());
+        assert(f.is_rw());
+        Random rg(seed, read_number);
+        f.add_file_version("1.1");
+        Channel_Id_Params cid_params;
+        cid_params.channel_number = std::to_string(1 + read_number % 512);
+        cid_params.digitisation = 8192;
+        cid_params.offset = 10;
+        cid_params.range = 1400;
+        cid_params.sampling_rate = 4000;
+        f.add_channel_id_params(cid_params);
+        auto rn = "Read_" + std::to_string(read_number);
+        auto read_id = "synthetic-" + std::to_string(seed) + "-" + std::to_string(read_number);
+        long long start_time = 1000000 + 10 * (long long)read_number * num_samples;
+        // raw samples: piecewise constant levels with gaussian noise
+        std::vector< Raw_Int_Sample > rsi;
+        rsi.reserve(num_samples);
+        std::vector< std::pair< long long, long long > > seg_l;
+        while (rsi.size() < num_samples)
+        {
+            long long level = rg.uniform_int(300, 900);
+            long long len = std::min< long long >(rg.uniform_int(min_event_length, max_event_length),
+                                                   num_samples - rsi.size());
+            seg_l.emplace_back(rsi.size(), len);
+            for (long long i = 0; i < len; ++i)
+            {
+                rsi.push_back(level + std::lround(noise_stdv * rg.normal()));
+            }
+        }
+        Raw_Samples_Params rs_params;
+        rs_params.read_id = read_id;
+        rs_params.read_number = read_number;
+        rs_params.start_mux = 1 + read_number % 4;
+        rs_params.start_time = start_time;
+        rs_params.duration = num_samples;
+        f.add_raw_samples(rn, rsi);
+        f.add_raw_samples_params(rn, rs_params);
+        auto rs = f.get_raw_samples(rn);
+        // eventdetection events: one per raw samples segment
+        std::vector< EventDetection_Event > ede;
+        ede.reserve(seg_l.size());
+        for (auto const & seg : seg_l)
+        {
+            EventDetection_Event e;
+            e.start = start_time + seg.first;
+            e.length = seg.second;
+            double s = 0.0;
+            double s2 = 0.0;
+            for (long long i = 0; i < seg.second; ++i)
+            {
+                double x = rs[seg.first + i];
+                s += x;
+                s2 += x * x;
+            }
+            e.mean = s / seg.second;
+            double var = (s2 - s * s / seg.second) / seg.second;
+            e.stdv = seg.second > 1 and var > 1e-3? std::sqrt(var) : 0.0;
+            ede.push_back(e);
+        }
+        EventDetection_Events_Params ede_params;
+        ede_params.read_id = read_id;
+        ede_params.read_number = read_number;
+        ede_params.scaling_used = 1;
+        ede_params.start_mux = rs_params.start_mux;
+        ede_params.start_time = start_time;
+        ede_params.duration = num_samples;
+        ede_params.median_before = 200.5;
+        ede_params.abasic_found = 0;
+        f.add_eventdetection_events(group_name(), rn, ede);
+        f.add_eventdetection_events_params(group_name(), rn, ede_params);
+        // basecall group params, as written by metrichor
+        Attr_Map bc_params;
+        bc_params["name"] = "ONT Sequencing Workflow";
+        bc_params["chimaera version"] = "1.0";
+        bc_params["dragonet version"] = "1.0";
+        bc_params["event_detection"] = "Analyses/EventDetection_" + group_name();
+        f.add_basecall_params(group_name(), bc_params);
+        // basecall events: template from the first half of ed events, complement from the second
+        std::vector< std::vector< Basecall_Event > > ev_v(2);
+        std::vector< std::string > sq_v(2);
+        for (unsigned st = 0; st < 2; ++st)
+        {
+            auto & ev = ev_v[st];
+            auto & sq = sq_v[st];
+            for (unsigned k = 0; k < kmer_size(); ++k) sq += random_base(rg);
+            size_t pos = 0;
+            for (size_t i = st * (ede.size() / 2); i < (st + 1) * (ede.size() / 2); ++i)
+            {
+                Basecall_Event e;
+                e.start = File::time_to_float(ede[i].start, cid_params);
+                e.length = File::time_to_float(ede[i].length, cid_params);
+                e.mean = ede[i].mean;
+                e.stdv = ede[i].stdv;
+                e.move = ev.empty()? 0 : rg.uniform_int(0, max_move);
+                for (long long k = 0; k < e.move; ++k) sq += random_base(rg);
+                pos += e.move;
+                std::fill(e.model_state.begin(), e.model_state.end(), 0);
+                std::copy_n(sq.begin() + pos, kmer_size(), e.model_state.begin());
+                e.p_model_state = rg.uniform_real();
+                ev.push_back(e);
+            }
+            f.add_basecall_fastq(st, group_name(), make_fastq(rg, rn + "_" + strand_name(st), sq));
+            f.add_basecall_events(st, group_name(), ev);
+            Basecall_Events_Params ev_params;
+            ev_params.start_time = ev.empty()? 0.0 : ev.front().start;
+            ev_params.duration = ev.empty()? 0.0 : ev.back().start + ev.back().length - ev.front().start;
+            f.add_basecall_events_params(st, group_name(), ev_params);
+        }
+        // 2D: template sequence, alignment pairing template and complement events in opposite order
+        f.add_basecall_fastq(2, group_name(), make_fastq(rg, rn + "_" + strand_name(2), sq_v[0]));
+        std::vector< Basecall_Alignment_Entry > al;
+        al.reserve(ev_v[0].size());
+        long long nc = ev_v[1].size();
+        for (size_t i = 0; i < ev_v[0].size(); ++i)
+        {
+            Basecall_Alignment_Entry a;
+            a.template_index = i;
+            a.complement_index = (long long)i < nc? nc - 1 - i : -1;
+            a.kmer = ev_v[0][i].model_state;
+            al.push_back(a);
+        }
+        f.add_basecall_alignment(group_name(), al);
+    } // generate()
+
+private:
+    unsigned seed;
+    size_t num_samples;
+    unsigned min_event_length;
+    unsigned max_event_length;
+    unsigned max_move;
+    double noise_stdv;
+
+    /// Portable random values: the std distributions are implementation-defined, so they are not used.
+    class Random
+    {
+    public:
+        Random(unsigned seed, unsigned read_number)
+        {
+            std::seed_seq sseq{ seed, read_number };
+            _rg.seed(sseq);
+        }
+        /// Integer uniform in [a, b]
+        long long uniform_int(long long a, long long b) { return a + (long long)(_rg() % (b - a + 1)); }
+        /// Real uniform in [0, 1)
+        double uniform_real() { return _rg() / 4294967296.0; }
+        /// Standard normal, by the Box-Muller transform
+        double normal()
+        {
+            double u = 1.0 - uniform_real();
+            double v = uniform_real();
+            return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * std::acos(-1.0) * v);
+        }
+    private:
+        std::mt19937 _rg;
+    }; // class Random
+
+    static char random_base(Random & rg) { return "ACGT"[rg.uniform_int(0, 3)]; }
+    static char const * strand_name(unsigned st) { return st == 0? "template" : st == 1? "complement" : "2d"; }
+
+    static std::string
+    make_fastq(Random & rg, std::string const & name, std::string const & sq)
+    {
+        std::string qv;
+        qv.reserve(sq.size());
+        for (size_t i = 0; i < sq.size(); ++i) qv += (char)rg.uniform_int(33, 60);
+        return "@" + name + "\n" + sq + "\n+\n" + qv;
+    }
+}; // class File_Generator
+
+} // namespace fast5
+
+#endif
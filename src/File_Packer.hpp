@@ -8,10 +8,23 @@
 #ifndef __FILE_PACKER_HPP
 #define __FILE_PACKER_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <mutex>
 #include <string>
 #include <set>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "fast5.hpp"
+#include "Pack_Archive.hpp"
 #include "logger.hpp"
 
 #define STATIC_MEMBER_WRAPPER(_type, _id, _init) \
@@ -20,6 +33,90 @@
 namespace fast5
 {
 
+/**
+ * Bounded blocking queue, used to connect pipeline stages.
+ * push() blocks while the queue is full, which provides backpressure to upstream stages.
+ */
+template < typename T >
+class Bounded_Queue
+{
+public:
+    explicit Bounded_Queue(size_t capacity) : _capacity(std::max< size_t >(capacity, 1)), _closed(false) {}
+    /// Push an element, blocking while the queue is full. Return false iff the queue is closed.
+    bool push(T && v)
+    {
+        std::unique_lock< std::mutex > lock(_mutex);
+        _not_full.wait(lock, [&] () { return _closed or _q.size() < _capacity; });
+        if (_closed) return false;
+        _q.push_back(std::move(v));
+        _not_empty.notify_one();
+        return true;
+    }
+    /// Pop an element, blocking while the queue is empty. Return false iff the queue is closed and empty.
+    bool pop(T & v)
+    {
+        std::unique_lock< std::mutex > lock(_mutex);
+        _not_empty.wait(lock, [&] () { return _closed or not _q.empty(); });
+        if (_q.empty()) return false;
+        v = std::move(_q.front());
+        _q.pop_front();
+        _not_full.notify_one();
+        return true;
+    }
+    /// Close the queue: pending elements can still be popped, no new ones can be pushed.
+    void close()
+    {
+        std::lock_guard< std::mutex > lock(_mutex);
+        _closed = true;
+        _not_full.notify_all();
+        _not_empty.notify_all();
+    }
+private:
+    std::mutex _mutex;
+    std::condition_variable _not_full;
+    std::condition_variable _not_empty;
+    std::deque< T > _q;
+    size_t _capacity;
+    bool _closed;
+}; // class Bounded_Queue
+
+/**
+ * Scoped meter: on destruction, add the time spent in its scope, or the HDF5 bytes
+ * read and written by the calling thread in its scope, to the given counters.
+ */
+class Scope_Meter
+{
+public:
+    explicit Scope_Meter(double & time) : Scope_Meter(&time, nullptr, nullptr) {}
+    Scope_Meter(size_t & read_bytes, size_t & write_bytes) : Scope_Meter(nullptr, &read_bytes, &write_bytes) {}
+    Scope_Meter(Scope_Meter const &) = delete;
+    Scope_Meter & operator = (Scope_Meter const &) = delete;
+    ~Scope_Meter()
+    {
+        if (_time)
+        {
+            *_time += std::chrono::duration< double >(clock_type::now() - _start).count();
+        }
+        if (_read_bytes)
+        {
+            auto const & io_cnt = hdf5_tools::IO_Counts::thread_counts();
+            *_read_bytes += io_cnt.read_bytes - _start_io_cnt.read_bytes;
+            *_write_bytes += io_cnt.write_bytes - _start_io_cnt.write_bytes;
+        }
+    }
+private:
+    typedef std::chrono::steady_clock clock_type;
+    Scope_Meter(double * time, size_t * read_bytes, size_t * write_bytes)
+        : _time(time), _read_bytes(read_bytes), _write_bytes(write_bytes),
+          _start(clock_type::now()), _start_io_cnt(hdf5_tools::IO_Counts::thread_counts())
+    {}
+    double * _time;
+    size_t * _read_bytes;
+    size_t * _write_bytes;
+    clock_type::time_point _start;
+    hdf5_tools::IO_Counts _start_io_cnt;
+}; // class Scope_Meter
+
 class File_Packer
 {
 public:
@@ -52,6 +149,47 @@ public:
         //
         double rs_total_duration;
         double rs_called_duration;
+        // per data type: monotonic time spent reading source data (for unpacking, this includes decoding),
+        // encoding it, checking packs, and writing destination data; and HDF5 bytes read and written
+        double rs_read_time;
+        double rs_encode_time;
+        double rs_check_time;
+        double rs_write_time;
+        size_t rs_read_bytes;
+        size_t rs_write_bytes;
+        //
+        double ed_read_time;
+        double ed_encode_time;
+        double ed_check_time;
+        double ed_write_time;
+        size_t ed_read_bytes;
+        size_t ed_write_bytes;
+        //
+        double fq_read_time;
+        double fq_encode_time;
+        double fq_check_time;
+        double fq_write_time;
+        size_t fq_read_bytes;
+        size_t fq_write_bytes;
+        //
+        double ev_read_time;
+        double ev_encode_time;
+        double ev_check_time;
+        double ev_write_time;
+        size_t ev_read_bytes;
+        size_t ev_write_bytes;
+        //
+        double al_read_time;
+        double al_encode_time;
+        double al_check_time;
+        double al_write_time;
+        size_t al_read_bytes;
+        size_t al_write_bytes;
+        // file open and close time; total HDF5 bytes read and written
+        double open_time;
+        double close_time;
+        size_t hdf5_read_bytes;
+        size_t hdf5_write_bytes;
 
         Counts() :
             //
@@ -80,7 +218,47 @@ public:
             al_move_bits(0),
             //
             rs_total_duration(0.0),
-            rs_called_duration(0.0)
+            rs_called_duration(0.0),
+            //
+            rs_read_time(0.0),
+            rs_encode_time(0.0),
+            rs_check_time(0.0),
+            rs_write_time(0.0),
+            rs_read_bytes(0),
+            rs_write_bytes(0),
+            //
+            ed_read_time(0.0),
+            ed_encode_time(0.0),
+            ed_check_time(0.0),
+            ed_write_time(0.0),
+            ed_read_bytes(0),
+            ed_write_bytes(0),
+            //
+            fq_read_time(0.0),
+            fq_encode_time(0.0),
+            fq_check_time(0.0),
+            fq_write_time(0.0),
+            fq_read_bytes(0),
+            fq_write_bytes(0),
+            //
+            ev_read_time(0.0),
+            ev_encode_time(0.0),
+            ev_check_time(0.0),
+            ev_write_time(0.0),
+            ev_read_bytes(0),
+            ev_write_bytes(0),
+            //
+            al_read_time(0.0),
+            al_encode_time(0.0),
+            al_check_time(0.0),
+            al_write_time(0.0),
+            al_read_bytes(0),
+            al_write_bytes(0),
+            //
+            open_time(0.0),
+            close_time(0.0),
+            hdf5_read_bytes(0),
+            hdf5_write_bytes(0)
         {}
         Counts & operator += (Counts const & other)
         {
@@ -111,10 +289,78 @@ public:
             //
             rs_total_duration += other.rs_total_duration;
             rs_called_duration += other.rs_called_duration;
+            //
+            rs_read_time += other.rs_read_time;
+            rs_encode_time += other.rs_encode_time;
+            rs_check_time += other.rs_check_time;
+            rs_write_time += other.rs_write_time;
+            rs_read_bytes += other.rs_read_bytes;
+            rs_write_bytes += other.rs_write_bytes;
+            //
+            ed_read_time += other.ed_read_time;
+            ed_encode_time += other.ed_encode_time;
+            ed_check_time += other.ed_check_time;
+            ed_write_time += other.ed_write_time;
+            ed_read_bytes += other.ed_read_bytes;
+            ed_write_bytes += other.ed_write_bytes;
+            //
+            fq_read_time += other.fq_read_time;
+            fq_encode_time += other.fq_encode_time;
+            fq_check_time += other.fq_check_time;
+            fq_write_time += other.fq_write_time;
+            fq_read_bytes += other.fq_read_bytes;
+            fq_write_bytes += other.fq_write_bytes;
+            //
+            ev_read_time += other.ev_read_time;
+            ev_encode_time += other.ev_encode_time;
+            ev_check_time += other.ev_check_time;
+            ev_write_time += other.ev_write_time;
+            ev_read_bytes += other.ev_read_bytes;
+            ev_write_bytes += other.ev_write_bytes;
+            //
+            al_read_time += other.al_read_time;
+            al_encode_time += other.al_encode_time;
+            al_check_time += other.al_check_time;
+            al_write_time += other.al_write_time;
+            al_read_bytes += other.al_read_bytes;
+            al_write_bytes += other.al_write_bytes;
+            //
+            open_time += other.open_time;
+            close_time += other.close_time;
+            hdf5_read_bytes += other.hdf5_read_bytes;
+            hdf5_write_bytes += other.hdf5_write_bytes;
             return *this;
         }
     };
 
+    /// Throughput counters of one pipeline stage
+    struct Stage_Counts
+    {
+        size_t files;
+        size_t bytes;
+        double busy_time;
+
+        Stage_Counts() : files(0), bytes(0), busy_time(0.0) {}
+        Stage_Counts & operator += (Stage_Counts const & other)
+        {
+            files += other.files;
+            bytes += other.bytes;
+            busy_time += other.busy_time;
+            return *this;
+        }
+    };
+
+    /// Throughput counters of the read/transform/write pipeline
+    struct Pipeline_Counts
+    {
+        Stage_Counts read;
+        Stage_Counts transform;
+        Stage_Counts write;
+        double total_time;
+
+        Pipeline_Counts() : total_time(0.0) {}
+    };
+
     File_Packer() :
         File_Packer(1)
     {}
@@ -130,138 +376,688 @@ public:
         ev_policy(_ev_policy),
         al_policy(_al_policy),
         check(true),
+        check_from_disk(false),
+        check_async(false),
         force(false),
+        in_memory(false),
         qv_bits(max_qv_bits()),
         p_model_state_bits(default_p_model_state_bits())
     {}
 
     void set_check(bool _check) { check = _check; }
+    void set_check_from_disk(bool _check_from_disk) { check_from_disk = _check_from_disk; }
+    void set_check_async(bool _check_async) { check_async = _check_async; }
     void set_force(bool _force) { force = _force; }
+    void set_in_memory(bool _in_memory) { in_memory = _in_memory; }
     void set_qv_bits(unsigned _qv_bits) { qv_bits = _qv_bits; }
     void set_p_model_state_bits(unsigned _p_model_state_bits) { p_model_state_bits = _p_model_state_bits; }
 
     STATIC_MEMBER_WRAPPER(unsigned const, max_qv_bits, 5)
     STATIC_MEMBER_WRAPPER(unsigned const, max_qv_mask, ((unsigned)1 << max_qv_bits()) - 1)
     STATIC_MEMBER_WRAPPER(unsigned const, default_p_model_state_bits, 2)
+    STATIC_MEMBER_WRAPPER(std::string const, multi_read_file_version, "2.0")
 
     void
     run(std::string const & ifn, std::string const & ofn) const
+    {
+        Counts cnt;
+        run(ifn, ofn, cnt);
+        counts += cnt;
+    } // run()
+
+    /**
+     * Pack many files in parallel.
+     * Worker threads pull (input, output) pairs from a shared queue, each accumulating its own counts;
+     * these are merged into the packer counts at the end. An error in one file does not stop the batch:
+     * the output file, if created by the failed job, is removed, and the error is reported.
+     * @param file_l List of (input file, output file) pairs.
+     * @param num_threads Number of worker threads.
+     * @return List of (index in @p file_l, error message), sorted by index.
+     */
+    std::vector< std::pair< size_t, std::string > >
+    run_batch(std::vector< std::pair< std::string, std::string > > const & file_l, unsigned num_threads) const
+    {
+        num_threads = std::max(1u, std::min< unsigned >(num_threads, file_l.size()));
+        std::vector< Counts > cnt_v(num_threads);
+        std::vector< std::vector< std::pair< size_t, std::string > > > err_v(num_threads);
+        std::atomic< size_t > next(0);
+        auto worker = [&] (unsigned tid) {
+            for (size_t i = next++; i < file_l.size(); i = next++)
+            {
+                auto const & ifn = file_l[i].first;
+                auto const & ofn = file_l[i].second;
+                bool output_existed = (bool)std::ifstream(ofn);
+                try
+                {
+                    Counts cnt;
+                    run(ifn, ofn, cnt);
+                    cnt_v[tid] += cnt;
+                }
+                catch (std::exception & e)
+                {
+                    if (not output_existed) std::remove(ofn.c_str());
+                    err_v[tid].emplace_back(i, e.what());
+                }
+            }
+        };
+        std::vector< std::thread > thread_v;
+        for (unsigned tid = 1; tid < num_threads; ++tid)
+        {
+            thread_v.emplace_back(worker, tid);
+        }
+        worker(0);
+        for (auto & t : thread_v)
+        {
+            t.join();
+        }
+        std::vector< std::pair< size_t, std::string > > res;
+        for (unsigned tid = 0; tid < num_threads; ++tid)
+        {
+            counts += cnt_v[tid];
+            res.insert(res.end(), err_v[tid].begin(), err_v[tid].end());
+        }
+        std::sort(res.begin(), res.end());
+        return res;
+    } // run_batch()
+
+    /**
+     * Pack many files with a staged pipeline.
+     * A reader thread loads input files into memory with one sequential read each; @p num_threads
+     * transform threads open the images, pack them into files created in memory, and extract the
+     * resulting images; a writer thread writes these out to temporary files that are then renamed.
+     * Stages are connected by queues holding at most @p queue_size files each, so a slow stage
+     * stalls the ones upstream of it. Pipeline counters are available via get_pipeline_counts().
+     * @param file_l List of (input file, output file) pairs.
+     * @param num_threads Number of transform threads.
+     * @param queue_size Capacity of each queue; if 0, use 2 * @p num_threads.
+     * @return List of (index in @p file_l, error message), sorted by index.
+     */
+    std::vector< std::pair< size_t, std::string > >
+    run_pipeline(std::vector< std::pair< std::string, std::string > > const & file_l,
+                 unsigned num_threads, size_t queue_size = 0) const
+    {
+        typedef std::chrono::steady_clock clock_type;
+        auto elapsed = [] (clock_type::time_point const & start) {
+            return std::chrono::duration< double >(clock_type::now() - start).count();
+        };
+        auto total_start = clock_type::now();
+        num_threads = std::max(1u, num_threads);
+        if (queue_size == 0) queue_size = 2 * num_threads;
+        // queue element: index in file_l, file image
+        typedef std::pair< size_t, std::vector< char > > item_type;
+        Bounded_Queue< item_type > read_q(queue_size);
+        Bounded_Queue< item_type > write_q(queue_size);
+        std::mutex err_mutex;
+        std::vector< std::pair< size_t, std::string > > res;
+        auto add_error = [&] (size_t i, std::string const & msg) {
+            std::lock_guard< std::mutex > lock(err_mutex);
+            res.emplace_back(i, msg);
+        };
+        Pipeline_Counts pl_cnt;
+        // reader stage
+        std::thread reader([&] () {
+            for (size_t i = 0; i < file_l.size(); ++i)
+            {
+                auto start = clock_type::now();
+                item_type item(i, std::vector< char >());
+                try
+                {
+                    if (not force and std::ifstream(file_l[i].second))
+                    {
+                        throw std::runtime_error(file_l[i].second + ": file exists");
+                    }
+                    item.second = File::read_image(file_l[i].first);
+                }
+                catch (std::exception & e)
+                {
+                    add_error(i, e.what());
+                    continue;
+                }
+                pl_cnt.read.files++;
+                pl_cnt.read.bytes += item.second.size();
+                pl_cnt.read.busy_time += elapsed(start);
+                if (not read_q.push(std::move(item))) break;
+            }
+            read_q.close();
+        });
+        // transform stage
+        std::vector< Counts > cnt_v(num_threads);
+        std::vector< Stage_Counts > transform_cnt_v(num_threads);
+        std::atomic< unsigned > transformers_left(num_threads);
+        std::vector< std::thread > transformer_v;
+        for (unsigned tid = 0; tid < num_threads; ++tid)
+        {
+            transformer_v.emplace_back([&, tid] () {
+                item_type item;
+                while (read_q.pop(item))
+                {
+                    auto start = clock_type::now();
+                    auto const & ifn = file_l[item.first].first;
+                    auto const & ofn = file_l[item.first].second;
+                    Counts cnt;
+                    try
+                    {
+                        File src_f;
+                        File dst_f;
+                        try
+                        {
+                            timed(cnt.open_time, [&] () {
+                                    src_f.open_image(item.second, ifn, src_open_flags());
+                                    dst_f.create_image(ofn);
+                                });
+                            transform(src_f, dst_f, cnt);
+                            timed(cnt.close_time, [&] () {
+                                    src_f.close();
+                                    item.second = dst_f.get_image();
+                                    dst_f.close();
+                                });
+                        }
+                        catch (hdf5_tools::Exception & e)
+                        {
+                            std::ostringstream oss;
+                            oss << ifn << ": HDF5 error: " << e.what();
+                            throw std::runtime_error(oss.str());
+                        }
+                    }
+                    catch (std::exception & e)
+                    {
+                        add_error(item.first, e.what());
+                        continue;
+                    }
+                    cnt_v[tid] += cnt;
+                    transform_cnt_v[tid].files++;
+                    transform_cnt_v[tid].bytes += item.second.size();
+                    transform_cnt_v[tid].busy_time += elapsed(start);
+                    if (not write_q.push(std::move(item))) break;
+                }
+                if (--transformers_left == 0) write_q.close();
+            });
+        }
+        // writer stage
+        std::thread writer([&] () {
+            item_type item;
+            while (write_q.pop(item))
+            {
+                auto start = clock_type::now();
+                auto const & ofn = file_l[item.first].second;
+                auto tmp_fn = ofn + ".tmp";
+                bool ok;
+                {
+                    std::ofstream ofs(tmp_fn, std::ios::binary);
+                    ok = (ofs and ofs.write(item.second.data(), item.second.size()) and ofs.flush());
+                }
+                ok = ok and std::rename(tmp_fn.c_str(), ofn.c_str()) == 0;
+                if (not ok)
+                {
+                    std::remove(tmp_fn.c_str());
+                    add_error(item.first, ofn + ": error writing file");
+                    continue;
+                }
+                pl_cnt.write.files++;
+                pl_cnt.write.bytes += item.second.size();
+                pl_cnt.write.busy_time += elapsed(start);
+            }
+        });
+        reader.join();
+        for (auto & t : transformer_v)
+        {
+            t.join();
+        }
+        writer.join();
+        for (unsigned tid = 0; tid < num_threads; ++tid)
+        {
+            counts += cnt_v[tid];
+            pl_cnt.transform += transform_cnt_v[tid];
+        }
+        pl_cnt.total_time = elapsed(total_start);
+        pipeline_counts = pl_cnt;
+        std::sort(res.begin(), res.end());
+        return res;
+    } // run_pipeline()
+
+    void
+    run(std::string const & ifn, std::string const & ofn, Counts & cnt) const
     {
         File src_f;
         File dst_f;
-        Counts cnt;
         try
         {
             // open files
-            src_f.open(ifn);
-            dst_f.create(ofn, force);
-            assert(src_f.is_open());
-            assert(dst_f.is_open());
-            assert(dst_f.is_rw());
-            // copy attributes under / and /UniqueGlobalKey
+            timed(cnt.open_time, [&] () {
+                    src_f.open(ifn, false, src_open_flags());
+                    dst_f.create(ofn, force, in_memory);
+                });
+            transform(src_f, dst_f, cnt);
+            // close files
+            timed(cnt.close_time, [&] () {
+                    src_f.close();
+                    dst_f.close();
+                });
+        }
+        catch (hdf5_tools::Exception & e)
+        {
+            std::ostringstream oss;
+            oss << ifn << ": HDF5 error: " << e.what();
+            throw std::runtime_error(oss.str());
+        }
+    } // run()
+
+    /**
+     * Write many files as reads of one multi-read file.
+     * Each input read is transformed according to the packer policies, so using copy policies
+     * converts files without repacking them. Inputs may be single-read or multi-read files.
+     * An error in one input does not stop the run: the reads it added are removed, and the error is reported.
+     * @param ifn_l List of input files.
+     * @param ofn Output multi-read file.
+     * @return List of (index in @p ifn_l, error message), sorted by index.
+     */
+    std::vector< std::pair< size_t, std::string > >
+    run_multi_read(std::vector< std::string > const & ifn_l, std::string const & ofn) const
+    {
+        std::vector< std::pair< size_t, std::string > > res;
+        Counts cnt;
+        File dst_f;
+        try
+        {
+            timed(cnt.open_time, [&] () {
+                    dst_f.create(ofn, force, in_memory);
+                    dst_f.add_file_version(multi_read_file_version());
+                });
+        }
+        catch (hdf5_tools::Exception & e)
+        {
+            std::ostringstream oss;
+            oss << ofn << ": HDF5 error: " << e.what();
+            throw std::runtime_error(oss.str());
+        }
+        for (size_t i = 0; i < ifn_l.size(); ++i)
+        {
+            try
+            {
+                File src_f;
+                Scope_Meter total_io_meter(cnt.hdf5_read_bytes, cnt.hdf5_write_bytes);
+                timed(cnt.open_time, [&] () { src_f.open(ifn_l[i], false, src_open_flags()); });
+                add_reads(src_f, dst_f, cnt);
+                timed(cnt.close_time, [&] () { src_f.close(); });
+            }
+            catch (hdf5_tools::Exception & e)
+            {
+                std::ostringstream oss;
+                oss << ifn_l[i] << ": HDF5 error: " << e.what();
+                res.emplace_back(i, oss.str());
+            }
+            catch (std::exception & e)
+            {
+                res.emplace_back(i, e.what());
+            }
+        }
+        timed(cnt.close_time, [&] () { dst_f.close(); });
+        counts += cnt;
+        return res;
+    } // run_multi_read()
+
+    /**
+     * Add the reads of many files to a pack archive.
+     * Raw samples and basecall fastq are archived packed, unless dropped by the rw and fq policies:
+     * existing packs are stored as they are, other data is packed (and checked) first. Other data
+     * is not archived. Inputs may be single-read or multi-read files. An error in one input does not
+     * stop the run: none of its reads are added, and the error is reported.
+     * @param ifn_l List of input files.
+     * @param afn Output archive.
+     * @param append If true, add reads to an existing archive; otherwise, create it.
+     * @return List of (index in @p ifn_l, error message), sorted by index.
+     */
+    std::vector< std::pair< size_t, std::string > >
+    run_to_pack_archive(std::vector< std::string > const & ifn_l, std::string const & afn, bool append) const
+    {
+        std::vector< std::pair< size_t, std::string > > res;
+        Counts cnt;
+        Pack_Archive_Writer ar;
+        timed(cnt.open_time, [&] () {
+                if (append) ar.open(afn);
+                else ar.create(afn, force);
+            });
+        for (size_t i = 0; i < ifn_l.size(); ++i)
+        {
+            try
+            {
+                std::vector< Pack_Archive::Read > r_l;
+                {
+                    File src_f;
+                    Scope_Meter total_io_meter(cnt.hdf5_read_bytes, cnt.hdf5_write_bytes);
+                    timed(cnt.open_time, [&] () { src_f.open(ifn_l[i], false, src_open_flags()); });
+                    auto read_id_l = (src_f.is_multi_read()
+                                      ? src_f.get_read_id_list()
+                                      : std::vector< std::string >(1, src_f.get_read_id()));
+                    for (auto const & read_id : read_id_l)
+                    {
+                        if (read_id.empty())
+                        {
+                            LOG_THROW
+                                << src_f.file_name() << ": read id not found";
+                        }
+                        if (ar.have_read(read_id))
+                        {
+                            LOG_THROW
+                                << src_f.file_name() << ": duplicate read id: " << read_id;
+                        }
+                        if (src_f.is_multi_read())
+                        {
+                            File src_rf;
+                            src_rf.open_read(src_f, read_id, src_open_flags());
+                            r_l.push_back(archive_read(src_rf, read_id, cnt));
+                        }
+                        else
+                        {
+                            r_l.push_back(archive_read(src_f, read_id, cnt));
+                        }
+                    }
+                    timed(cnt.close_time, [&] () { src_f.close(); });
+                }
+                for (auto const & r : r_l)
+                {
+                    ar.add_read(r);
+                }
+            }
+            catch (hdf5_tools::Exception & e)
+            {
+                std::ostringstream oss;
+                oss << ifn_l[i] << ": HDF5 error: " << e.what();
+                res.emplace_back(i, oss.str());
+            }
+            catch (std::exception & e)
+            {
+                res.emplace_back(i, e.what());
+            }
+        }
+        timed(cnt.close_time, [&] () { ar.close(); });
+        counts += cnt;
+        return res;
+    } // run_to_pack_archive()
+
+    /**
+     * Write the reads of a pack archive as reads of one multi-read file.
+     * With the rw and fq unpack policies, raw samples and basecall fastq are decoded from the
+     * archive; with the pack and copy policies, their packs are written as they are.
+     * @param afn Input archive.
+     * @param ofn Output multi-read file.
+     */
+    void
+    run_from_pack_archive(std::string const & afn, std::string const & ofn) const
+    {
+        Counts cnt;
+        Pack_Archive ar;
+        File dst_f;
+        try
+        {
+            Scope_Meter total_io_meter(cnt.hdf5_read_bytes, cnt.hdf5_write_bytes);
+            timed(cnt.open_time, [&] () {
+                    ar.open(afn);
+                    dst_f.create(ofn, force, in_memory);
+                    dst_f.add_file_version(multi_read_file_version());
+                });
+            for (auto const & read_id : ar.get_read_id_list())
+            {
+                auto r = timed(cnt.rs_read_time, [&] () { return ar.get_read(read_id); });
+                dst_f.add_read(read_id);
+                File dst_rf;
+                dst_rf.open_read(dst_f, read_id);
+                dst_rf.add_channel_id_params(r.channel_id_params);
+                if (rw_policy != 0 and r.have_raw_samples)
+                {
+                    Scope_Meter io_meter(cnt.rs_read_bytes, cnt.rs_write_bytes);
+                    auto const & rn = r.raw_samples_read_name;
+                    if (rw_policy == 2)
+                    {
+                        auto rsi_ds = timed(cnt.rs_encode_time, [&] () { return File::unpack_rw(r.raw_samples_pack); });
+                        timed(cnt.rs_write_time, [&] () { dst_rf.add_raw_samples_dataset(rn, rsi_ds); });
+                    }
+                    else
+                    {
+                        timed(cnt.rs_write_time, [&] () { dst_rf.add_raw_samples(rn, r.raw_samples_pack); });
+                    }
+                }
+                if (fq_policy != 0)
+                {
+                    Scope_Meter io_meter(cnt.fq_read_bytes, cnt.fq_write_bytes);
+                    for (auto const & fq : r.basecall_fastq_l)
+                    {
+                        if (fq_policy == 2)
+                        {
+                            auto fq_unpack = timed(cnt.fq_encode_time, [&] () { return File::unpack_fq(fq.pack); });
+                            timed(cnt.fq_write_time, [&] () { dst_rf.add_basecall_fastq(fq.st, fq.gr, fq_unpack); });
+                        }
+                        else
+                        {
+                            timed(cnt.fq_write_time, [&] () { dst_rf.add_basecall_fastq(fq.st, fq.gr, fq.pack); });
+                        }
+                    }
+                }
+            }
+            timed(cnt.close_time, [&] () {
+                    dst_f.close();
+                    ar.close();
+                });
+        }
+        catch (hdf5_tools::Exception & e)
+        {
+            std::ostringstream oss;
+            oss << ofn << ": HDF5 error: " << e.what();
+            throw std::runtime_error(oss.str());
+        }
+        counts += cnt;
+    } // run_from_pack_archive()
+
+    void reset_counts() const
+    {
+        counts = Counts();
+    }
+
+    Counts const & get_counts() const
+    {
+        return counts;
+    }
+
+    Pipeline_Counts const & get_pipeline_counts() const
+    {
+        return pipeline_counts;
+    }
+private:
+    int rw_policy;
+    int ed_policy;
+    int fq_policy;
+    int ev_policy;
+    int al_policy;
+    // check packing by decoding each pack in memory; if check_from_disk, by reading it back from the output file
+    bool check;
+    bool check_from_disk;
+    // run in-memory checks on a separate thread, overlapped with writing the pack
+    bool check_async;
+    bool force;
+    bool in_memory;
+    unsigned qv_bits;
+    unsigned p_model_state_bits;
+    mutable Counts counts;
+    mutable Pipeline_Counts pipeline_counts;
+
+    /**
+     * Start the decoding step of an in-memory check.
+     * If no in-memory check is done, return a deferred future that is never run.
+     */
+    template < typename Function >
+    std::future< typename std::result_of< Function() >::type >
+    start_check(Function && f) const
+    {
+        bool async = check and not check_from_disk and check_async;
+        return std::async(async? std::launch::async : std::launch::deferred, std::forward< Function >(f));
+    }
+
+    /// Sections of the source file catalog used by the packing policies; raw samples are
+    /// always needed, to unpack eventdetection and basecall events.
+    unsigned
+    src_open_flags() const
+    {
+        return (File::open_raw
+                | (ed_policy or ev_policy? File::open_eventdetection : 0)
+                | (fq_policy or ev_policy or al_policy? File::open_basecall : 0));
+    }
+
+    /// Run @p f, adding the time it takes to @p time.
+    template < typename Function >
+    static auto
+    timed(double & time, Function && f) -> decltype(f())
+    {
+        Scope_Meter meter(time);
+        return f();
+    }
+
+    void
+    transform(File const & src_f, File & dst_f, Counts & cnt) const
+    {
+        assert(src_f.is_open());
+        assert(dst_f.is_open());
+        assert(dst_f.is_rw());
+        Scope_Meter total_io_meter(cnt.hdf5_read_bytes, cnt.hdf5_write_bytes);
+        if (not src_f.is_multi_read())
+        {
+            transform_read(src_f, dst_f, cnt);
+        }
+        else
+        {
             copy_attributes(src_f, dst_f, "", false);
-            copy_attributes(src_f, dst_f, "/UniqueGlobalKey", true);
-            std::set< std::string > bc_gr_s;
-            // process raw samples
+            add_reads(src_f, dst_f, cnt);
+        }
+    } // transform()
+
+    /**
+     * Transform the reads of @p src_f into new reads of the multi-read file @p dst_f.
+     * If one read fails, it is removed from @p dst_f, and the error is rethrown.
+     */
+    void
+    add_reads(File const & src_f, File & dst_f, Counts & cnt) const
+    {
+        auto read_id_l = (src_f.is_multi_read()
+                          ? src_f.get_read_id_list()
+                          : std::vector< std::string >(1, src_f.get_read_id()));
+        for (auto const & read_id : read_id_l)
+        {
+            if (read_id.empty())
+            {
+                LOG_THROW
+                    << src_f.file_name() << ": read id not found";
+            }
+            dst_f.add_read(read_id);
+            try
+            {
+                File dst_rf;
+                dst_rf.open_read(dst_f, read_id);
+                if (src_f.is_multi_read())
+                {
+                    File src_rf;
+                    src_rf.open_read(src_f, read_id, src_open_flags());
+                    transform_read(src_rf, dst_rf, cnt);
+                }
+                else
+                {
+                    transform_read(src_f, dst_rf, cnt);
+                }
+            }
+            catch (...)
+            {
+                dst_f.remove_read(read_id);
+                throw;
+            }
+        }
+    } // add_reads()
+
+    void
+    transform_read(File const & src_f, File & dst_f, Counts & cnt) const
+    {
+        copy_global_attributes(src_f, dst_f);
+        std::set< std::string > bc_gr_s;
+        // process raw samples
+        {
+            Scope_Meter io_meter(cnt.rs_read_bytes, cnt.rs_write_bytes);
             if (rw_policy == 1)
             {
                 pack_rw(src_f, dst_f, cnt);
             }
             else if (rw_policy == 2)
             {
-                unpack_rw(src_f, dst_f);
+                unpack_rw(src_f, dst_f, cnt);
             }
             else if (rw_policy == 3)
             {
-                copy_rw(src_f, dst_f);
+                copy_rw(src_f, dst_f, cnt);
             }
-            // process eventdetection events
+        }
+        // process eventdetection events
+        {
+            Scope_Meter io_meter(cnt.ed_read_bytes, cnt.ed_write_bytes);
             if (ed_policy == 1)
             {
                 pack_ed(src_f, dst_f, cnt);
             }
             else if (ed_policy == 2)
             {
-                unpack_ed(src_f, dst_f);
+                unpack_ed(src_f, dst_f, cnt);
             }
             else if (ed_policy == 3)
             {
-                copy_ed(src_f, dst_f);
+                copy_ed(src_f, dst_f, cnt);
             }
-            // process basecall fastq
+        }
+        // process basecall fastq
+        {
+            Scope_Meter io_meter(cnt.fq_read_bytes, cnt.fq_write_bytes);
             if (fq_policy == 1)
             {
                 pack_fq(src_f, dst_f, bc_gr_s, cnt);
             }
             else if (fq_policy == 2)
             {
-                unpack_fq(src_f, dst_f, bc_gr_s);
+                unpack_fq(src_f, dst_f, bc_gr_s, cnt);
             }
             else if (fq_policy == 3)
             {
-                copy_fq(src_f, dst_f, bc_gr_s);
+                copy_fq(src_f, dst_f, bc_gr_s, cnt);
             }
-            // process basecall events
+        }
+        // process basecall events
+        {
+            Scope_Meter io_meter(cnt.ev_read_bytes, cnt.ev_write_bytes);
             if (ev_policy == 1)
             {
                 pack_ev(src_f, dst_f, bc_gr_s, cnt);
             }
             else if (ev_policy == 2)
             {
-                unpack_ev(src_f, dst_f, bc_gr_s);
+                unpack_ev(src_f, dst_f, bc_gr_s, cnt);
             }
             else if (ev_policy == 3)
             {
-                copy_ev(src_f, dst_f, bc_gr_s);
+                copy_ev(src_f, dst_f, bc_gr_s, cnt);
             }
-            // process basecall alignments
+        }
+        // process basecall alignments
+        {
+            Scope_Meter io_meter(cnt.al_read_bytes, cnt.al_write_bytes);
             if (al_policy == 1)
             {
                 pack_al(src_f, dst_f, bc_gr_s, cnt);
             }
             else if (al_policy == 2)
             {
-                unpack_al(src_f, dst_f, bc_gr_s);
+                unpack_al(src_f, dst_f, bc_gr_s, cnt);
             }
             else if (al_policy == 3)
             {
-                copy_al(src_f, dst_f, bc_gr_s);
+                copy_al(src_f, dst_f, bc_gr_s, cnt);
             }
-            // copy basecall params
-            copy_basecall_params(src_f, dst_f, bc_gr_s);
-            // close files
-            src_f.close();
-            dst_f.close();
-        }
-        catch (hdf5_tools::Exception & e)
-        {
-            std::ostringstream oss;
-            oss << ifn << ": HDF5 error: " << e.what();
-            throw std::runtime_error(oss.str());
         }
-        counts += cnt;
-    } // run()
-
-    void reset_counts() const
-    {
-        counts = Counts();
-    }
-
-    Counts const & get_counts() const
-    {
-        return counts;
-    }
-private:
-    int rw_policy;
-    int ed_policy;
-    int fq_policy;
-    int ev_policy;
-    int al_policy;
-    bool check;
-    bool force;
-    unsigned qv_bits;
-    unsigned p_model_state_bits;
-    mutable Counts counts;
+        // copy basecall params
+        copy_basecall_params(src_f, dst_f, bc_gr_s);
+    } // transform_read()
 
     void
     pack_rw(File const & src_f, File & dst_f, Counts & cnt) const
@@ -271,43 +1067,24 @@ private:
         {
             if (src_f.have_raw_samples_pack(rn))
             {
-                auto rs_pack = src_f.get_raw_samples_pack(rn);
-                dst_f.add_raw_samples(rn, rs_pack);
+                auto rs_pack = timed(cnt.rs_read_time, [&] () { return src_f.get_raw_samples_pack(rn); });
+                timed(cnt.rs_write_time, [&] () { dst_f.add_raw_samples(rn, rs_pack); });
             }
             else if (src_f.have_raw_samples_unpack(rn))
             {
-                auto rsi_ds = src_f.get_raw_int_samples_dataset(rn);
+                auto rsi_ds = timed(cnt.rs_read_time, [&] () { return src_f.get_raw_int_samples_dataset(rn); });
                 auto & rsi = rsi_ds.first;
                 auto & rs_params = rsi_ds.second;
-                auto rs_pack = src_f.pack_rw(rsi_ds);
-                dst_f.add_raw_samples(rn, rs_pack);
+                auto rs_pack = timed(cnt.rs_encode_time, [&] () { return src_f.pack_rw(rsi_ds); });
+                auto rsi_ds_unpack_f = start_check([&] () { return File::unpack_rw(rs_pack); });
+                timed(cnt.rs_write_time, [&] () { dst_f.add_raw_samples(rn, rs_pack); });
                 if (check)
                 {
-                    auto rsi_ds_unpack = dst_f.get_raw_int_samples_dataset(rn);
-                    auto & rsi_unpack = rsi_ds_unpack.first;
-                    auto & rs_params_unpack = rsi_ds_unpack.second;
-                    if (not (rs_params_unpack == rs_params))
-                    {
-                        LOG_THROW
-                            << "check failed: rs_params_unpack!=rs_params";
-                    }
-                    if (rsi_unpack.size() != rsi.size())
-                    {
-                        LOG_THROW
-                            << "check failed: rs_unpack.size=" << rsi_unpack.size()
-                            << " rs_orig.size=" << rsi.size();
-
-                    }
-                    for (unsigned i = 0; i < rsi_unpack.size(); ++i)
-                    {
-                        if (rsi_unpack[i] != rsi[i])
-                        {
-                            LOG_THROW
-                                << "check failed: i=" << i
-                                << " rs_unpack=" << rsi_unpack[i]
-                                << " rs_orig=" << rsi[i];
-                        }
-                    }
+                    Scope_Meter check_meter(cnt.rs_check_time);
+                    auto rsi_ds_unpack = (check_from_disk
+                                          ? dst_f.get_raw_int_samples_dataset(rn)
+                                          : rsi_ds_unpack_f.get());
+                    check_rw(rsi_ds, rsi_ds_unpack);
                 }
                 cnt.rs_count += rsi.size();
                 cnt.rs_bits += rs_pack.signal.size() * sizeof(rs_pack.signal[0]) * 8;
@@ -325,32 +1102,62 @@ private:
         }
     } // pack_rw()
 
+    /// Check unpacked raw samples against the originals.
+    static void
+    check_rw(Raw_Int_Samples_Dataset const & rsi_ds, Raw_Int_Samples_Dataset const & rsi_ds_unpack)
+    {
+        auto & rsi = rsi_ds.first;
+        auto & rsi_unpack = rsi_ds_unpack.first;
+        auto & rs_params_unpack = rsi_ds_unpack.second;
+        if (not (rs_params_unpack == rsi_ds.second))
+        {
+            LOG_THROW
+                << "check failed: rs_params_unpack!=rs_params";
+        }
+        if (rsi_unpack.size() != rsi.size())
+        {
+            LOG_THROW
+                << "check failed: rs_unpack.size=" << rsi_unpack.size()
+                << " rs_orig.size=" << rsi.size();
+        }
+        for (unsigned i = 0; i < rsi_unpack.size(); ++i)
+        {
+            if (rsi_unpack[i] != rsi[i])
+            {
+                LOG_THROW
+                    << "check failed: i=" << i
+                    << " rs_unpack=" << rsi_unpack[i]
+                    << " rs_orig=" << rsi[i];
+            }
+        }
+    } // check_rw()
+
     void
-    unpack_rw(File const & src_f, File & dst_f) const
+    unpack_rw(File const & src_f, File & dst_f, Counts & cnt) const
     {
         auto rn_l = src_f.get_raw_samples_read_name_list();
         for (auto const & rn : rn_l)
         {
-            auto rsi_ds = src_f.get_raw_int_samples_dataset(rn);
-            dst_f.add_raw_samples_dataset(rn, rsi_ds);
+            auto rsi_ds = timed(cnt.rs_read_time, [&] () { return src_f.get_raw_int_samples_dataset(rn); });
+            timed(cnt.rs_write_time, [&] () { dst_f.add_raw_samples_dataset(rn, rsi_ds); });
         }
     } // unpack_rw()
 
     void
-    copy_rw(File const & src_f, File & dst_f) const
+    copy_rw(File const & src_f, File & dst_f, Counts & cnt) const
     {
         auto rn_l = src_f.get_raw_samples_read_name_list();
         for (auto const & rn : rn_l)
         {
             if (src_f.have_raw_samples_unpack(rn))
             {
-                auto rsi_ds = src_f.get_raw_int_samples_dataset(rn);
-                dst_f.add_raw_samples_dataset(rn, rsi_ds);
+                auto rsi_ds = timed(cnt.rs_read_time, [&] () { return src_f.get_raw_int_samples_dataset(rn); });
+                timed(cnt.rs_write_time, [&] () { dst_f.add_raw_samples_dataset(rn, rsi_ds); });
             }
             else if (src_f.have_raw_samples_pack(rn))
             {
-                auto rs_pack = src_f.get_raw_samples_pack(rn);
-                dst_f.add_raw_samples(rn, rs_pack);
+                auto rs_pack = timed(cnt.rs_read_time, [&] () { return src_f.get_raw_samples_pack(rn); });
+                timed(cnt.rs_write_time, [&] () { dst_f.add_raw_samples(rn, rs_pack); });
             }
         }
     } // copy_rw()
@@ -368,22 +1175,41 @@ private:
                 dst_f.add_eventdetection_params(gr, ed_params);
                 if (src_f.have_eventdetection_events_pack(gr, rn))
                 {
-                    auto ede_pack = src_f.get_eventdetection_events_pack(gr, rn);
-                    dst_f.add_eventdetection_events(gr, rn, ede_pack);
+                    auto ede_pack = timed(cnt.ed_read_time, [&] () { return src_f.get_eventdetection_events_pack(gr, rn); });
+                    timed(cnt.ed_write_time, [&] () { dst_f.add_eventdetection_events(gr, rn, ede_pack); });
                 }
                 else if (src_f.have_eventdetection_events(gr, rn))
                 {
-                    auto ede_ds = src_f.get_eventdetection_events_dataset(gr, rn);
+                    auto ede_ds = timed(cnt.ed_read_time, [&] () { return src_f.get_eventdetection_events_dataset(gr, rn); });
                     auto & ede = ede_ds.first;
                     auto & ede_params = ede_ds.second;
-                    auto ede_pack = src_f.pack_ed(ede_ds);
-                    dst_f.add_eventdetection_events(gr, rn, ede_pack);
+                    auto ede_pack = timed(cnt.ed_encode_time, [&] () { return src_f.pack_ed(ede_ds); });
+                    // unpacking needs raw samples; they are lossless, so take them from the source
+                    Raw_Samples_Dataset rs_ds;
+                    bool have_rs = dst_f.have_raw_samples(rn);
+                    if (check and not check_from_disk and have_rs)
+                    {
+                        rs_ds = timed(cnt.ed_check_time, [&] () { return src_f.get_raw_samples_dataset(rn); });
+                    }
+                    auto ede_ds_unpack_f = start_check([&] () {
+                            if (not have_rs)
+                            {
+                                LOG_THROW_(std::logic_error)
+                                    << "missing raw samples required to unpack eventdetection events: gr=" << gr
+                                    << " rn=" << rn;
+                            }
+                            return File::unpack_ed(ede_pack, rs_ds);
+                        });
+                    timed(cnt.ed_write_time, [&] () { dst_f.add_eventdetection_events(gr, rn, ede_pack); });
                     if (check)
                     {
+                        Scope_Meter check_meter(cnt.ed_check_time);
                         decltype(ede_ds) ede_ds_unpack;
                         try
                         {
-                            ede_ds_unpack = dst_f.get_eventdetection_events_dataset(gr, rn);
+                            ede_ds_unpack = (check_from_disk
+                                             ? dst_f.get_eventdetection_events_dataset(gr, rn)
+                                             : ede_ds_unpack_f.get());
                         }
                         catch (std::logic_error & e)
                         {
@@ -454,7 +1280,7 @@ private:
     } // pack_ed()
 
     void
-    unpack_ed(File const & src_f, File & dst_f) const
+    unpack_ed(File const & src_f, File & dst_f, Counts & cnt) const
     {
         auto gr_l = src_f.get_eventdetection_group_list();
         for (auto const & gr : gr_l)
@@ -464,14 +1290,14 @@ private:
             {
                 auto ed_params = src_f.get_eventdetection_params(gr);
                 dst_f.add_eventdetection_params(gr, ed_params);
-                auto ede_ds = src_f.get_eventdetection_events_dataset(gr, rn);
-                dst_f.add_eventdetection_events_dataset(gr, rn, ede_ds);
+                auto ede_ds = timed(cnt.ed_read_time, [&] () { return src_f.get_eventdetection_events_dataset(gr, rn); });
+                timed(cnt.ed_write_time, [&] () { dst_f.add_eventdetection_events_dataset(gr, rn, ede_ds); });
             }
         }
     } // unpack_ed()
 
     void
-    copy_ed(File const & src_f, File & dst_f) const
+    copy_ed(File const & src_f, File & dst_f, Counts & cnt) const
     {
         auto gr_l = src_f.get_eventdetection_group_list();
         for (auto const & gr : gr_l)
@@ -483,13 +1309,13 @@ private:
                 dst_f.add_eventdetection_params(gr, ed_params);
                 if (src_f.have_eventdetection_events_unpack(gr, rn))
                 {
-                    auto ede_ds = src_f.get_eventdetection_events_dataset(gr, rn);
-                    dst_f.add_eventdetection_events_dataset(gr, rn, ede_ds);
+                    auto ede_ds = timed(cnt.ed_read_time, [&] () { return src_f.get_eventdetection_events_dataset(gr, rn); });
+                    timed(cnt.ed_write_time, [&] () { dst_f.add_eventdetection_events_dataset(gr, rn, ede_ds); });
                 }
                 else if (src_f.have_eventdetection_events_pack(gr, rn))
                 {
-                    auto ede_pack = src_f.get_eventdetection_events_pack(gr, rn);
-                    dst_f.add_eventdetection_events(gr, rn, ede_pack);
+                    auto ede_pack = timed(cnt.ed_read_time, [&] () { return src_f.get_eventdetection_events_pack(gr, rn); });
+                    timed(cnt.ed_write_time, [&] () { dst_f.add_eventdetection_events(gr, rn, ede_pack); });
                 }
             }
         }
@@ -507,59 +1333,25 @@ private:
                 if (src_f.have_basecall_fastq_pack(st, gr))
                 {
                     bc_gr_s.insert(gr);
-                    auto fq_pack = src_f.get_basecall_fastq_pack(st, gr);
-                    dst_f.add_basecall_fastq(st, gr, fq_pack);
+                    auto fq_pack = timed(cnt.fq_read_time, [&] () { return src_f.get_basecall_fastq_pack(st, gr); });
+                    timed(cnt.fq_write_time, [&] () { dst_f.add_basecall_fastq(st, gr, fq_pack); });
                 }
                 else if (src_f.have_basecall_fastq_unpack(st, gr))
                 {
                     compute_bp_seq_count = true;
                     bc_gr_s.insert(gr);
-                    auto fq = src_f.get_basecall_fastq(st, gr);
+                    auto fq = timed(cnt.fq_read_time, [&] () { return src_f.get_basecall_fastq(st, gr); });
                     auto fqa = src_f.split_fq(fq);
-                    auto fq_pack = src_f.pack_fq(fq, qv_bits);
-                    dst_f.add_basecall_fastq(st, gr, fq_pack);
+                    auto fq_pack = timed(cnt.fq_encode_time, [&] () { return src_f.pack_fq(fq, qv_bits); });
+                    auto fq_unpack_f = start_check([&] () { return File::unpack_fq(fq_pack); });
+                    timed(cnt.fq_write_time, [&] () { dst_f.add_basecall_fastq(st, gr, fq_pack); });
                     if (check)
                     {
-                        auto fq_unpack = dst_f.get_basecall_fastq(st, gr);
-                        auto fqa_unpack = src_f.split_fq(fq_unpack);
-                        if (fqa_unpack[0] != fqa[0])
-                        {
-                            LOG_THROW
-                                << "check failed: st=" << st
-                                << " gr=" << gr
-                                << " fq_unpack_name=" << fqa_unpack[0]
-                                << " fq_orig_name=" << fqa[0];
-                        }
-                        if (fqa_unpack[1] != fqa[1])
-                        {
-                            LOG_THROW
-                                << "check failed: st=" << st
-                                << " gr=" << gr
-                                << " fq_unpack_bp=" << fqa_unpack[1]
-                                << " fq_orig_bp=" << fqa[1];
-                        }
-                        if (fqa_unpack[3].size() != fqa[3].size())
-                        {
-                            LOG_THROW
-                                << "check failed: st=" << st
-                                << " gr=" << gr
-                                << " fq_unpack_qv_size=" << fqa_unpack[3].size()
-                                << " fq_orig_qv_size=" << fqa[3].size();
-                        }
-                        auto qv_mask = max_qv_mask() & (max_qv_mask() << (max_qv_bits() - qv_bits));
-                        for (unsigned i = 0; i < fqa_unpack[3].size(); ++i)
-                        {
-                            if ((std::min<unsigned>(fqa_unpack[3][i] - 33, max_qv_mask()) & qv_mask) !=
-                                (std::min<unsigned>(fqa[3][i] - 33, max_qv_mask()) & qv_mask))
-                            {
-                                LOG_THROW
-                                    << "check failed: st=" << st
-                                    << " gr=" << gr
-                                    << " i=" << i
-                                    << " fq_unpack_qv=" << fqa_unpack[3][i]
-                                    << " fq_orig_qv=" << fqa[3][i];
-                            }
-                        }
+                        Scope_Meter check_meter(cnt.fq_check_time);
+                        auto fq_unpack = (check_from_disk
+                                          ? dst_f.get_basecall_fastq(st, gr)
+                                          : fq_unpack_f.get());
+                        check_fq(st, gr, fqa, fq_unpack);
                     }
                     cnt.fq_count += fqa[1].size();
                     cnt.fq_bp_bits += fq_pack.bp.size() * sizeof(fq_pack.bp[0]) * 8;
@@ -596,8 +1388,54 @@ private:
         }
     } // pack_fq()
 
+    /// Check an unpacked fastq against the original, split in fields.
+    void
+    check_fq(unsigned st, std::string const & gr, std::array< std::string, 4 > const & fqa,
+             std::string const & fq_unpack) const
+    {
+        auto fqa_unpack = File::split_fq(fq_unpack);
+        if (fqa_unpack[0] != fqa[0])
+        {
+            LOG_THROW
+                << "check failed: st=" << st
+                << " gr=" << gr
+                << " fq_unpack_name=" << fqa_unpack[0]
+                << " fq_orig_name=" << fqa[0];
+        }
+        if (fqa_unpack[1] != fqa[1])
+        {
+            LOG_THROW
+                << "check failed: st=" << st
+                << " gr=" << gr
+                << " fq_unpack_bp=" << fqa_unpack[1]
+                << " fq_orig_bp=" << fqa[1];
+        }
+        if (fqa_unpack[3].size() != fqa[3].size())
+        {
+            LOG_THROW
+                << "check failed: st=" << st
+                << " gr=" << gr
+                << " fq_unpack_qv_size=" << fqa_unpack[3].size()
+                << " fq_orig_qv_size=" << fqa[3].size();
+        }
+        auto qv_mask = max_qv_mask() & (max_qv_mask() << (max_qv_bits() - qv_bits));
+        for (unsigned i = 0; i < fqa_unpack[3].size(); ++i)
+        {
+            if ((std::min<unsigned>(fqa_unpack[3][i] - 33, max_qv_mask()) & qv_mask) !=
+                (std::min<unsigned>(fqa[3][i] - 33, max_qv_mask()) & qv_mask))
+            {
+                LOG_THROW
+                    << "check failed: st=" << st
+                    << " gr=" << gr
+                    << " i=" << i
+                    << " fq_unpack_qv=" << fqa_unpack[3][i]
+                    << " fq_orig_qv=" << fqa[3][i];
+            }
+        }
+    } // check_fq()
+
     void
-    unpack_fq(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s) const
+    unpack_fq(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s, Counts & cnt) const
     {
         for (unsigned st = 0; st < 3; ++st)
         {
@@ -607,15 +1445,15 @@ private:
                 if (src_f.have_basecall_fastq(st, gr))
                 {
                     bc_gr_s.insert(gr);
-                    auto fq = src_f.get_basecall_fastq(st, gr);
-                    dst_f.add_basecall_fastq(st, gr, fq);
+                    auto fq = timed(cnt.fq_read_time, [&] () { return src_f.get_basecall_fastq(st, gr); });
+                    timed(cnt.fq_write_time, [&] () { dst_f.add_basecall_fastq(st, gr, fq); });
                 }
             }
         }
     } // unpack_fq()
 
     void
-    copy_fq(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s) const
+    copy_fq(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s, Counts & cnt) const
     {
         for (unsigned st = 0; st < 3; ++st)
         {
@@ -625,19 +1463,92 @@ private:
                 if (src_f.have_basecall_fastq_unpack(st, gr))
                 {
                     bc_gr_s.insert(gr);
-                    auto fq = src_f.get_basecall_fastq(st, gr);
-                    dst_f.add_basecall_fastq(st, gr, fq);
+                    auto fq = timed(cnt.fq_read_time, [&] () { return src_f.get_basecall_fastq(st, gr); });
+                    timed(cnt.fq_write_time, [&] () { dst_f.add_basecall_fastq(st, gr, fq); });
                 }
                 else if (src_f.have_basecall_fastq_pack(st, gr))
                 {
                     bc_gr_s.insert(gr);
-                    auto fq_pack = src_f.get_basecall_fastq_pack(st, gr);
-                    dst_f.add_basecall_fastq(st, gr, fq_pack);
+                    auto fq_pack = timed(cnt.fq_read_time, [&] () { return src_f.get_basecall_fastq_pack(st, gr); });
+                    timed(cnt.fq_write_time, [&] () { dst_f.add_basecall_fastq(st, gr, fq_pack); });
                 }
             }
         }
     } // copy_fq()
 
+    /**
+     * Collect the packs of one read, for a pack archive.
+     * @param src_f Source file, or read view.
+     * @param read_id Read id.
+     */
+    Pack_Archive::Read
+    archive_read(File const & src_f, std::string const & read_id, Counts & cnt) const
+    {
+        Pack_Archive::Read r;
+        r.read_id = read_id;
+        r.channel_id_params = src_f.get_channel_id_params();
+        if (rw_policy != 0 and src_f.have_raw_samples())
+        {
+            Scope_Meter io_meter(cnt.rs_read_bytes, cnt.rs_write_bytes);
+            auto const & rn = src_f.get_raw_samples_read_name_list().front();
+            r.have_raw_samples = true;
+            r.raw_samples_read_name = rn;
+            if (src_f.have_raw_samples_pack(rn))
+            {
+                r.raw_samples_pack = timed(cnt.rs_read_time, [&] () { return src_f.get_raw_samples_pack(rn); });
+            }
+            else
+            {
+                auto rsi_ds = timed(cnt.rs_read_time, [&] () { return src_f.get_raw_int_samples_dataset(rn); });
+                r.raw_samples_pack = timed(cnt.rs_encode_time, [&] () { return File::pack_rw(rsi_ds); });
+                if (check)
+                {
+                    Scope_Meter check_meter(cnt.rs_check_time);
+                    check_rw(rsi_ds, File::unpack_rw(r.raw_samples_pack));
+                }
+                cnt.rs_count += rsi_ds.first.size();
+                cnt.rs_bits += r.raw_samples_pack.signal.size() * 8;
+            }
+        }
+        if (fq_policy != 0)
+        {
+            Scope_Meter io_meter(cnt.fq_read_bytes, cnt.fq_write_bytes);
+            for (unsigned st = 0; st < 3; ++st)
+            {
+                for (auto const & gr : src_f.get_basecall_strand_group_list(st))
+                {
+                    Pack_Archive::Read::Fastq fq;
+                    fq.st = st;
+                    fq.gr = gr;
+                    if (src_f.have_basecall_fastq_pack(st, gr))
+                    {
+                        fq.pack = timed(cnt.fq_read_time, [&] () { return src_f.get_basecall_fastq_pack(st, gr); });
+                    }
+                    else if (src_f.have_basecall_fastq_unpack(st, gr))
+                    {
+                        auto fq_orig = timed(cnt.fq_read_time, [&] () { return src_f.get_basecall_fastq(st, gr); });
+                        fq.pack = timed(cnt.fq_encode_time, [&] () { return File::pack_fq(fq_orig, qv_bits); });
+                        auto fqa = File::split_fq(fq_orig);
+                        if (check)
+                        {
+                            Scope_Meter check_meter(cnt.fq_check_time);
+                            check_fq(st, gr, fqa, File::unpack_fq(fq.pack));
+                        }
+                        cnt.fq_count += fqa[1].size();
+                        cnt.fq_bp_bits += fq.pack.bp.size() * 8;
+                        cnt.fq_qv_bits += fq.pack.qv.size() * 8;
+                    }
+                    else
+                    {
+                        continue;
+                    }
+                    r.basecall_fastq_l.push_back(std::move(fq));
+                }
+            }
+        }
+        return r;
+    } // archive_read()
+
     void
     pack_ev(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s, Counts & cnt) const
     {
@@ -649,8 +1560,8 @@ private:
                 if (src_f.have_basecall_events_pack(st, gr))
                 {
                     bc_gr_s.insert(gr);
-                    auto ev_pack = src_f.get_basecall_events_pack(st, gr);
-                    dst_f.add_basecall_events(st, gr, ev_pack);
+                    auto ev_pack = timed(cnt.ev_read_time, [&] () { return src_f.get_basecall_events_pack(st, gr); });
+                    timed(cnt.ev_write_time, [&] () { dst_f.add_basecall_events(st, gr, ev_pack); });
                 }
                 else if (src_f.have_basecall_events_unpack(st, gr))
                 {
@@ -666,7 +1577,7 @@ private:
                         continue;
                     }
                     bc_gr_s.insert(gr);
-                    auto ev_ds = src_f.get_basecall_events_dataset(st, gr);
+                    auto ev_ds = timed(cnt.ev_read_time, [&] () { return src_f.get_basecall_events_dataset(st, gr); });
                     auto & ev = ev_ds.first;
                     auto & ev_params = ev_ds.second;
                     // sampling rate
@@ -677,25 +1588,58 @@ private:
                         LOG_THROW
                             << "missing fastq required to pack basecall events: st=" << st << " gr=" << gr;
                     }
-                    auto sq = src_f.get_basecall_seq(st, gr);
+                    auto sq = timed(cnt.ev_read_time, [&] () { return src_f.get_basecall_seq(st, gr); });
                     // ed group
                     auto ed_gr = src_f.get_basecall_eventdetection_group(gr);
                     std::vector< EventDetection_Event > ed;
                     if (not ed_gr.empty())
                     {
-                        ed = src_f.get_eventdetection_events(ed_gr);
+                        ed = timed(cnt.ev_read_time, [&] () { return src_f.get_eventdetection_events(ed_gr); });
                     }
                     // try to find mean_sd_temp
                     auto median_sd_temp = src_f.get_basecall_median_sd_temp(gr);
-                    auto ev_pack = src_f.pack_ev(ev_ds, bc_desc, sq, ed, ed_gr,
+                    auto ev_pack = timed(cnt.ev_encode_time, [&] () {
+                            return src_f.pack_ev(ev_ds, bc_desc, sq, ed, ed_gr,
                                                  cid_params, median_sd_temp, p_model_state_bits);
-                    dst_f.add_basecall_events(st, gr, ev_pack);
+                        });
+                    // unpacking needs raw samples if there is no ed group; they are lossless, so take them from the source
+                    Raw_Samples_Dataset rs_ds;
+                    bool have_sq = dst_f.have_basecall_seq(st, gr);
+                    bool have_ed = (not ed_gr.empty()
+                                    ? dst_f.have_eventdetection_events(ed_gr)
+                                    : dst_f.have_raw_samples());
+                    if (check and not check_from_disk and ed_gr.empty() and have_ed)
+                    {
+                        rs_ds = timed(cnt.ev_check_time, [&] () { return src_f.get_raw_samples_dataset(); });
+                    }
+                    auto ev_ds_unpack_f = start_check([&] () {
+                            if (not have_sq)
+                            {
+                                LOG_THROW_(std::logic_error)
+                                    << "missing fastq required to unpack basecall events: st=" << st
+                                    << " gr=" << gr;
+                            }
+                            if (not have_ed)
+                            {
+                                LOG_THROW_(std::logic_error)
+                                    << "missing " << (not ed_gr.empty()? "eventdetection events" : "raw samples")
+                                    << " required to unpack basecall events: st=" << st
+                                    << " gr=" << gr;
+                            }
+                            return File::unpack_ev(ev_pack, sq,
+                                                   not ed_gr.empty()? ed : File::unpack_implicit_ed(ev_pack, rs_ds),
+                                                   cid_params);
+                        });
+                    timed(cnt.ev_write_time, [&] () { dst_f.add_basecall_events(st, gr, ev_pack); });
                     if (check)
                     {
+                        Scope_Meter check_meter(cnt.ev_check_time);
                         decltype(ev_ds) ev_ds_unpack;
                         try
                         {
-                            ev_ds_unpack = dst_f.get_basecall_events_dataset(st, gr);
+                            ev_ds_unpack = (check_from_disk
+                                            ? dst_f.get_basecall_events_dataset(st, gr)
+                                            : ev_ds_unpack_f.get());
                         }
                         catch (std::logic_error & e)
                         {
@@ -803,7 +1747,7 @@ private:
     } // pack_ev()
 
     void
-    unpack_ev(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s) const
+    unpack_ev(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s, Counts & cnt) const
     {
         for (unsigned st = 0; st < 2; ++st)
         {
@@ -813,15 +1757,15 @@ private:
                 if (src_f.have_basecall_events(st, gr))
                 {
                     bc_gr_s.insert(gr);
-                    auto ev_ds = src_f.get_basecall_events_dataset(st, gr);
-                    dst_f.add_basecall_events_dataset(st, gr, ev_ds);
+                    auto ev_ds = timed(cnt.ev_read_time, [&] () { return src_f.get_basecall_events_dataset(st, gr); });
+                    timed(cnt.ev_write_time, [&] () { dst_f.add_basecall_events_dataset(st, gr, ev_ds); });
                 }
             }
         }
     } // unpack_ev()
 
     void
-    copy_ev(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s) const
+    copy_ev(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s, Counts & cnt) const
     {
         for (unsigned st = 0; st < 2; ++st)
         {
@@ -831,14 +1775,14 @@ private:
                 if (src_f.have_basecall_events_unpack(st, gr))
                 {
                     bc_gr_s.insert(gr);
-                    auto ev_ds = src_f.get_basecall_events_dataset(st, gr);
-                    dst_f.add_basecall_events_dataset(st, gr, ev_ds);
+                    auto ev_ds = timed(cnt.ev_read_time, [&] () { return src_f.get_basecall_events_dataset(st, gr); });
+                    timed(cnt.ev_write_time, [&] () { dst_f.add_basecall_events_dataset(st, gr, ev_ds); });
                 }
                 else if (src_f.have_basecall_events_pack(st, gr))
                 {
                     bc_gr_s.insert(gr);
-                    auto ev_pack = src_f.get_basecall_events_pack(st, gr);
-                    dst_f.add_basecall_events(st, gr, ev_pack);
+                    auto ev_pack = timed(cnt.ev_read_time, [&] () { return src_f.get_basecall_events_pack(st, gr); });
+                    timed(cnt.ev_write_time, [&] () { dst_f.add_basecall_events(st, gr, ev_pack); });
                 }
             }
         }
@@ -853,8 +1797,8 @@ private:
             if (src_f.have_basecall_alignment_pack(gr))
             {
                 bc_gr_s.insert(gr);
-                auto al_pack = src_f.get_basecall_alignment_pack(gr);
-                dst_f.add_basecall_alignment(gr, al_pack);
+                auto al_pack = timed(cnt.al_read_time, [&] () { return src_f.get_basecall_alignment_pack(gr); });
+                timed(cnt.al_write_time, [&] () { dst_f.add_basecall_alignment(gr, al_pack); });
             }
             else if (src_f.have_basecall_alignment_unpack(gr))
             {
@@ -870,19 +1814,28 @@ private:
                     continue;
                 }
                 bc_gr_s.insert(gr);
-                auto al = src_f.get_basecall_alignment(gr);
+                auto al = timed(cnt.al_read_time, [&] () { return src_f.get_basecall_alignment(gr); });
                 // basecall seq
                 if (not src_f.have_basecall_seq(2, gr))
                 {
                     LOG_THROW
                         << "missing fastq required to pack basecall alignment: gr=" << gr;
                 }
-                auto seq = src_f.get_basecall_seq(2, gr);
-                auto al_pack = src_f.pack_al(al, seq);
-                dst_f.add_basecall_alignment(gr, al_pack);
+                auto seq = timed(cnt.al_read_time, [&] () { return src_f.get_basecall_seq(2, gr); });
+                auto al_pack = timed(cnt.al_encode_time, [&] () { return src_f.pack_al(al, seq); });
+                bool have_seq = dst_f.have_basecall_seq(2, gr);
+                auto al_unpack_f = start_check([&] () {
+                        return (have_seq
+                                ? File::unpack_al(al_pack, seq)
+                                : std::vector< Basecall_Alignment_Entry >());
+                    });
+                timed(cnt.al_write_time, [&] () { dst_f.add_basecall_alignment(gr, al_pack); });
                 if (check)
                 {
-                    auto al_unpack = dst_f.get_basecall_alignment(gr);
+                    Scope_Meter check_meter(cnt.al_check_time);
+                    auto al_unpack = (check_from_disk
+                                      ? dst_f.get_basecall_alignment(gr)
+                                      : al_unpack_f.get());
                     if (al_unpack.size() != al.size())
                     {
                         LOG_THROW
@@ -925,7 +1878,7 @@ private:
     } // pack_al()
 
     void
-    unpack_al(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s) const
+    unpack_al(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s, Counts & cnt) const
     {
         auto gr_l = src_f.get_basecall_strand_group_list(2);
         for (auto const & gr : gr_l)
@@ -933,14 +1886,14 @@ private:
             if (src_f.have_basecall_alignment(gr))
             {
                 bc_gr_s.insert(gr);
-                auto al = src_f.get_basecall_alignment(gr);
-                dst_f.add_basecall_alignment(gr, al);
+                auto al = timed(cnt.al_read_time, [&] () { return src_f.get_basecall_alignment(gr); });
+                timed(cnt.al_write_time, [&] () { dst_f.add_basecall_alignment(gr, al); });
             }
         }
     } // unpack_al()
 
     void
-    copy_al(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s) const
+    copy_al(File const & src_f, File & dst_f, std::set< std::string > & bc_gr_s, Counts & cnt) const
     {
         auto gr_l = src_f.get_basecall_strand_group_list(2);
         for (auto const & gr : gr_l)
@@ -948,14 +1901,14 @@ private:
             if (src_f.have_basecall_alignment_unpack(gr))
             {
                 bc_gr_s.insert(gr);
-                auto al = src_f.get_basecall_alignment(gr);
-                dst_f.add_basecall_alignment(gr, al);
+                auto al = timed(cnt.al_read_time, [&] () { return src_f.get_basecall_alignment(gr); });
+                timed(cnt.al_write_time, [&] () { dst_f.add_basecall_alignment(gr, al); });
             }
             else if (src_f.have_basecall_alignment_pack(gr))
             {
                 bc_gr_s.insert(gr);
-                auto al_pack = src_f.get_basecall_alignment_pack(gr);
-                dst_f.add_basecall_alignment(gr, al_pack);
+                auto al_pack = timed(cnt.al_read_time, [&] () { return src_f.get_basecall_alignment_pack(gr); });
+                timed(cnt.al_write_time, [&] () { dst_f.add_basecall_alignment(gr, al_pack); });
             }
         }
     } // copy_al()
@@ -975,6 +1928,34 @@ private:
     {
         File::Base::copy_attributes(src_f, dst_f, p, recurse);
     } // copy_attributes()
+
+    /**
+     * Copy attributes describing a read: those under /UniqueGlobalKey, or directly under the read group
+     * in a multi-read file. The attributes under / are copied only between single-read files.
+     */
+    void
+    copy_global_attributes(File const & src_f, File const & dst_f) const
+    {
+        if (not src_f.is_read_view() and not dst_f.is_read_view())
+        {
+            copy_attributes(src_f, dst_f, "", false);
+        }
+        auto src_p = src_f.unique_global_key_path();
+        auto dst_p = dst_f.unique_global_key_path();
+        if (not src_f.Base::group_exists(src_p)) return;
+        File::Base::copy_attributes(src_f, dst_f, src_p, dst_p, false);
+        auto sg_l = src_f.Base::list_group(src_p);
+        for (auto const & sg : sg_l)
+        {
+            auto p = src_p + "/" + sg;
+            // in a read view, the read group also holds the raw samples and analyses
+            if (p == src_f.raw_samples_params_path(sg)
+                or p == src_f.eventdetection_root_path()
+                or p == src_f.basecall_root_path()
+                or not src_f.Base::group_exists(p)) continue;
+            File::Base::copy_attributes(src_f, dst_f, p, dst_p + "/" + sg, true);
+        }
+    } // copy_global_attributes()
 }; // class File_Packer
 
 } // namespace fast5
@@ -149,6 +149,19 @@ public:
     template < typename Int_Type >
     std::vector< Int_Type >
     decode(Code_Type const & v, Code_Params_Type const & v_params) const
+    {
+        return decode< Int_Type >(v.data(), v.size(), v_params);
+    }
+
+    /**
+     * Decode a code held in a byte range, e.g. in a memory-mapped file, without copying it.
+     * @param v_ptr Start of code.
+     * @param v_size Code length in bytes.
+     * @param v_params Code parameters.
+     */
+    template < typename Int_Type >
+    std::vector< Int_Type >
+    decode(std::uint8_t const * v_ptr, size_t v_size, Code_Params_Type const & v_params) const
     {
         check_params(v_params);
         bool decode_diff = v_params.at("code_diff") == "1";
@@ -157,14 +170,14 @@ public:
         std::uint8_t buff_len = 0;
         bool reset = true;
         Int_Type last = 0;
-        unsigned i = 0;
-        while (i < v.size() or buff_len > 0)
+        size_t i = 0;
+        while (i < v_size or buff_len > 0)
         {
             assert(buff_len <= 64);
             // fill buffer
-            while (i < v.size() and buff_len <= 56)
+            while (i < v_size and buff_len <= 56)
             {
-                uint64_t y = v[i];
+                uint64_t y = v_ptr[i];
                 buff |= (y << buff_len);
                 buff_len += 8;
                 ++i;
@@ -248,7 +261,6 @@ public:
     static Huffman_Packer const &
     get_coder(std::string const & cwm_name)
     {
-        static_init();
         if (cwm_m().count(cwm_name) == 0)
         {
             LOG_THROW
@@ -310,15 +322,15 @@ private:
         _cwm[v] = std::make_pair(cw, cw_l);
     }
 
-    static std::map< std::string, Huffman_Packer > & cwm_m()
+    // initialized once, thread-safe; read-only afterwards
+    static std::map< std::string, Huffman_Packer > const & cwm_m()
     {
-        static std::map< std::string, Huffman_Packer > _cwm_m;
+        static std::map< std::string, Huffman_Packer > const _cwm_m = load_builtin_cwm_m();
         return _cwm_m;
     }
-    static void static_init()
+    static std::map< std::string, Huffman_Packer > load_builtin_cwm_m()
     {
-        static bool inited = false;
-        if (inited) return;
+        std::map< std::string, Huffman_Packer > res;
         std::deque< std::deque< std::string > > dd;
         dd.push_back(
 #include "cwmap.fast5_rw_1.inl"
@@ -341,15 +353,14 @@ private:
         dd.push_back(
 #include "cwmap.fast5_ev_move_1.inl"
             );
-        cwm_m().clear();
         for (auto & d : dd)
         {
             auto cwm_name = d.front();
             Huffman_Packer hc(d.begin() + 1, d.end(), cwm_name);
-            cwm_m()[cwm_name] = std::move(hc);
+            res[cwm_name] = std::move(hc);
         }
-        inited = true;
-    } // static_init()
+        return res;
+    } // load_builtin_cwm_m()
 }; // class Huffman_Packer
 
 } // namespace fast5
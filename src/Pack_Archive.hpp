@@ -0,0 +1,701 @@
+//
+// Part of: https://github.com/mateidavid/fast5
+//
+// Copyright (c) 2015-2017 Matei David, Ontario Institute for Cancer Research
+// MIT License
+//
+
+#ifndef __PACK_ARCHIVE_HPP
+#define __PACK_ARCHIVE_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fast5.hpp"
+#include "logger.hpp"
+
+namespace fast5
+{
+
+/**
+ * Read-only access to a pack archive: a container of packed reads, without HDF5.
+ *
+ * An archive holds, for each read, its channel id params and the packs of its raw samples and
+ * basecall fastq, as stored in packed fast5 files. Records are appended back to back by
+ * Pack_Archive_Writer, and a footer holds the read ids sorted, with the offset and size of
+ * each record. The file layout is:
+ *  - header: magic
+ *  - records
+ *  - footer: Disk_Entry[num_entries], sorted by read id; pool of null-terminated read ids
+ *  - trailer: Trailer
+ * Integers and doubles are stored in host byte order.
+ *
+ * The archive is memory-mapped on open. Lookups binary search the footer in place, and packs
+ * are decoded straight from the mapped bytes.
+ */
+class Pack_Archive
+{
+public:
+    /// One archived read.
+    struct Read
+    {
+        /// One basecall fastq pack.
+        struct Fastq
+        {
+            unsigned st;
+            std::string gr;
+            Basecall_Fastq_Pack pack;
+        }; // struct Fastq
+
+        std::string read_id;
+        Channel_Id_Params channel_id_params;
+        bool have_raw_samples;
+        // raw read name in the source file
+        std::string raw_samples_read_name;
+        Raw_Samples_Pack raw_samples_pack;
+        std::vector< Fastq > basecall_fastq_l;
+
+        Read() : have_raw_samples(false) {}
+    }; // struct Read
+
+    Pack_Archive() : _data(nullptr), _size(0) {}
+    Pack_Archive(std::string const & fn) : Pack_Archive() { open(fn); }
+    Pack_Archive(Pack_Archive const &) = delete;
+    Pack_Archive & operator = (Pack_Archive const &) = delete;
+    ~Pack_Archive() { close(); }
+
+    bool is_open() const { return _data != nullptr; }
+    std::string const & file_name() const { return _file_name; }
+
+    /**
+     * Open and memory-map an archive.
+     * @param fn Archive file.
+     */
+    void
+    open(std::string const & fn)
+    {
+        close();
+        int fd = ::open(fn.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            LOG_THROW
+                << fn << ": error opening pack archive";
+        }
+        struct stat st;
+        void * data = MAP_FAILED;
+        if (fstat(fd, &st) == 0 and st.st_size > 0)
+        {
+            data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            LOG_THROW
+                << fn << ": error mapping pack archive";
+        }
+        _data = static_cast< char const * >(data);
+        _size = st.st_size;
+        _file_name = fn;
+        if (not is_valid())
+        {
+            close();
+            LOG_THROW
+                << fn << ": not a valid pack archive";
+        }
+    } // open()
+    void
+    close()
+    {
+        if (not is_open()) return;
+        munmap(const_cast< char * >(_data), _size);
+        _data = nullptr;
+        _size = 0;
+        _file_name.clear();
+    } // close()
+
+    /// Number of reads in the archive.
+    size_t size() const { return is_open()? trailer().num_entries : 0; }
+    /// Read ids, sorted.
+    std::vector< std::string >
+    get_read_id_list() const
+    {
+        std::vector< std::string > res;
+        res.reserve(size());
+        for (size_t i = 0; i < size(); ++i)
+        {
+            res.push_back(pool_string(disk_entry(i).read_id_offset));
+        }
+        return res;
+    }
+    bool
+    have_read(std::string const & read_id) const
+    {
+        return find(read_id) < size();
+    }
+
+    //
+    // Per-read accessors, decoding from the mapped archive
+    //
+    Channel_Id_Params
+    get_channel_id_params(std::string const & read_id) const
+    {
+        return parse_record(read_id).channel_id_params;
+    }
+    bool
+    have_raw_samples(std::string const & read_id) const
+    {
+        return parse_record(read_id).have_raw_samples;
+    }
+    Raw_Samples_Params
+    get_raw_samples_params(std::string const & read_id) const
+    {
+        auto rv = parse_raw_record(read_id);
+        return rv.raw_samples_params;
+    }
+    std::vector< Raw_Int_Sample >
+    get_raw_int_samples(std::string const & read_id) const
+    {
+        auto rv = parse_raw_record(read_id);
+        return File::rw_coder().decode< Raw_Int_Sample >(rv.signal.ptr, rv.signal.size, rv.signal.params);
+    }
+    std::vector< Raw_Sample >
+    get_raw_samples(std::string const & read_id) const
+    {
+        auto rv = parse_raw_record(read_id);
+        auto rsi = File::rw_coder().decode< Raw_Int_Sample >(rv.signal.ptr, rv.signal.size, rv.signal.params);
+        std::vector< Raw_Sample > res;
+        res.reserve(rsi.size());
+        for (auto int_level : rsi)
+        {
+            res.push_back(File::raw_sample_to_float(int_level, rv.channel_id_params));
+        }
+        return res;
+    }
+    /// Basecall groups with a fastq for the given strand.
+    std::vector< std::string >
+    get_basecall_strand_group_list(std::string const & read_id, unsigned st) const
+    {
+        std::vector< std::string > res;
+        for (auto const & fv : parse_record(read_id).basecall_fastq_l)
+        {
+            if (fv.st == st) res.push_back(fv.gr);
+        }
+        return res;
+    }
+    bool
+    have_basecall_fastq(std::string const & read_id, unsigned st, std::string const & gr) const
+    {
+        auto rv = parse_record(read_id);
+        return find_fastq(rv, st, gr) != nullptr;
+    }
+    std::string
+    get_basecall_fastq(std::string const & read_id, unsigned st, std::string const & gr) const
+    {
+        auto rv = parse_record(read_id);
+        auto fv_ptr = find_fastq(rv, st, gr);
+        if (not fv_ptr)
+        {
+            LOG_THROW
+                << _file_name << ": basecall fastq not found: read_id=" << read_id << " st=" << st << " gr=" << gr;
+        }
+        auto bp = File::fq_bp_coder().decode< std::int8_t >(fv_ptr->bp.ptr, fv_ptr->bp.size, fv_ptr->bp.params);
+        auto qv = File::fq_qv_coder().decode< std::uint8_t >(fv_ptr->qv.ptr, fv_ptr->qv.size, fv_ptr->qv.params);
+        return File::make_fq(fv_ptr->read_name, bp, qv);
+    }
+
+    /**
+     * Get an archived read, with copies of its packs.
+     * @param read_id Read id.
+     */
+    Read
+    get_read(std::string const & read_id) const
+    {
+        auto rv = parse_record(read_id);
+        Read res;
+        res.read_id = rv.read_id;
+        res.channel_id_params = rv.channel_id_params;
+        res.have_raw_samples = rv.have_raw_samples;
+        if (rv.have_raw_samples)
+        {
+            res.raw_samples_read_name = rv.raw_samples_read_name;
+            res.raw_samples_pack.params = rv.raw_samples_params;
+            res.raw_samples_pack.signal_params = rv.signal.params;
+            res.raw_samples_pack.signal.assign(rv.signal.ptr, rv.signal.ptr + rv.signal.size);
+        }
+        for (auto const & fv : rv.basecall_fastq_l)
+        {
+            Read::Fastq fq;
+            fq.st = fv.st;
+            fq.gr = fv.gr;
+            fq.pack.read_name = fv.read_name;
+            fq.pack.qv_bits = fv.qv_bits;
+            fq.pack.bp_params = fv.bp.params;
+            fq.pack.bp.assign(fv.bp.ptr, fv.bp.ptr + fv.bp.size);
+            fq.pack.qv_params = fv.qv.params;
+            fq.pack.qv.assign(fv.qv.ptr, fv.qv.ptr + fv.qv.size);
+            res.basecall_fastq_l.push_back(std::move(fq));
+        }
+        return res;
+    } // get_read()
+
+
+private:
+    friend class Pack_Archive_Writer;
+
+    char const * _data;
+    size_t _size;
+    std::string _file_name;
+
+    static char const * magic() { return "F5PKAR01"; }
+    static size_t header_size() { return 8; }
+
+    struct Disk_Entry
+    {
+        std::uint64_t read_id_offset;
+        std::uint64_t record_offset;
+        std::uint64_t record_size;
+    }; // struct Disk_Entry
+    struct Trailer
+    {
+        std::uint64_t footer_offset;
+        std::uint64_t num_entries;
+        std::uint64_t pool_size;
+        char magic[8];
+    }; // struct Trailer
+
+    /// A code stored in the archive, referred to in place.
+    struct Code_View
+    {
+        Attr_Map params;
+        std::uint8_t const * ptr;
+        size_t size;
+    }; // struct Code_View
+    struct Fastq_View
+    {
+        unsigned st;
+        std::string gr;
+        std::string read_name;
+        std::uint8_t qv_bits;
+        Code_View bp;
+        Code_View qv;
+    }; // struct Fastq_View
+    /// A parsed record; codes are left in the mapped archive.
+    struct Record_View
+    {
+        std::string read_id;
+        Channel_Id_Params channel_id_params;
+        bool have_raw_samples;
+        std::string raw_samples_read_name;
+        Raw_Samples_Params raw_samples_params;
+        Code_View signal;
+        std::vector< Fastq_View > basecall_fastq_l;
+    }; // struct Record_View
+
+    /// Bounds-checked reader of record fields.
+    class Cursor
+    {
+    public:
+        Cursor(char const * p, char const * end) : _p(p), _end(end) {}
+        template < typename T >
+        T get()
+        {
+            need(sizeof(T));
+            T res;
+            std::memcpy(&res, _p, sizeof(T));
+            _p += sizeof(T);
+            return res;
+        }
+        std::string get_string()
+        {
+            auto n = get< std::uint32_t >();
+            need(n);
+            std::string res(_p, n);
+            _p += n;
+            return res;
+        }
+        Code_View get_code()
+        {
+            Code_View res;
+            auto n = get< std::uint32_t >();
+            for (std::uint32_t i = 0; i < n; ++i)
+            {
+                auto k = get_string();
+                res.params[k] = get_string();
+            }
+            auto sz = get< std::uint64_t >();
+            need(sz);
+            res.ptr = reinterpret_cast< std::uint8_t const * >(_p);
+            res.size = sz;
+            _p += sz;
+            return res;
+        }
+    private:
+        char const * _p;
+        char const * _end;
+        void need(std::uint64_t n) const
+        {
+            if (n > static_cast< std::uint64_t >(_end - _p))
+            {
+                LOG_THROW
+                    << "corrupt pack archive record";
+            }
+        }
+    }; // class Cursor
+
+    template < typename T >
+    static void put(std::string & s, T x)
+    {
+        s.append(reinterpret_cast< char const * >(&x), sizeof(T));
+    }
+    static void put_string(std::string & s, std::string const & x)
+    {
+        put< std::uint32_t >(s, x.size());
+        s += x;
+    }
+    static void put_code(std::string & s, Huffman_Packer::Code_Type const & v, Attr_Map const & v_params)
+    {
+        put< std::uint32_t >(s, v_params.size());
+        for (auto const & p : v_params)
+        {
+            put_string(s, p.first);
+            put_string(s, p.second);
+        }
+        put< std::uint64_t >(s, v.size());
+        s.append(reinterpret_cast< char const * >(v.data()), v.size());
+    }
+    /**
+     * Serialize a read record.
+     * @param r Read.
+     * @return Record bytes.
+     */
+    static std::string
+    make_record(Read const & r)
+    {
+        std::string res;
+        put_string(res, r.read_id);
+        put_string(res, r.channel_id_params.channel_number);
+        put< double >(res, r.channel_id_params.digitisation);
+        put< double >(res, r.channel_id_params.offset);
+        put< double >(res, r.channel_id_params.range);
+        put< double >(res, r.channel_id_params.sampling_rate);
+        put< std::uint8_t >(res, r.have_raw_samples);
+        if (r.have_raw_samples)
+        {
+            auto const & rs_pack = r.raw_samples_pack;
+            put_string(res, r.raw_samples_read_name);
+            put_string(res, rs_pack.params.read_id);
+            put< std::int64_t >(res, rs_pack.params.read_number);
+            put< std::int64_t >(res, rs_pack.params.start_mux);
+            put< std::int64_t >(res, rs_pack.params.start_time);
+            put< std::int64_t >(res, rs_pack.params.duration);
+            put_code(res, rs_pack.signal, rs_pack.signal_params);
+        }
+        put< std::uint32_t >(res, r.basecall_fastq_l.size());
+        for (auto const & fq : r.basecall_fastq_l)
+        {
+            put< std::uint8_t >(res, fq.st);
+            put_string(res, fq.gr);
+            put_string(res, fq.pack.read_name);
+            put< std::uint8_t >(res, fq.pack.qv_bits);
+            put_code(res, fq.pack.bp, fq.pack.bp_params);
+            put_code(res, fq.pack.qv, fq.pack.qv_params);
+        }
+        return res;
+    } // make_record()
+
+    Trailer trailer() const
+    {
+        Trailer res;
+        std::memcpy(&res, _data + _size - sizeof(Trailer), sizeof(Trailer));
+        return res;
+    }
+    size_t pool_offset() const { return trailer().footer_offset + size() * sizeof(Disk_Entry); }
+    Disk_Entry disk_entry(size_t i) const
+    {
+        Disk_Entry res;
+        std::memcpy(&res, _data + trailer().footer_offset + i * sizeof(Disk_Entry), sizeof(Disk_Entry));
+        return res;
+    }
+    char const * pool_string(std::uint64_t offset) const
+    {
+        return _data + pool_offset() + offset;
+    }
+
+    /// Check header, trailer, and footer offsets, so that lookups stay within the archive.
+    bool
+    is_valid() const
+    {
+        if (_size < header_size() + sizeof(Trailer)) return false;
+        if (std::memcmp(_data, magic(), header_size()) != 0) return false;
+        auto t = trailer();
+        if (std::memcmp(t.magic, magic(), sizeof(t.magic)) != 0) return false;
+        size_t footer_end = _size - sizeof(Trailer);
+        // guard against overflow before checking the footer size
+        if (t.footer_offset < header_size() or t.footer_offset > footer_end
+            or t.num_entries > (footer_end - t.footer_offset) / sizeof(Disk_Entry)
+            or t.pool_size != footer_end - t.footer_offset - t.num_entries * sizeof(Disk_Entry)) return false;
+        if (t.num_entries > 0 and (t.pool_size == 0 or _data[footer_end - 1] != '\0')) return false;
+        for (size_t i = 0; i < t.num_entries; ++i)
+        {
+            auto de = disk_entry(i);
+            if (de.read_id_offset >= t.pool_size
+                or de.record_offset < header_size() or de.record_offset > t.footer_offset
+                or de.record_size > t.footer_offset - de.record_offset) return false;
+        }
+        return true;
+    } // is_valid()
+
+    /// Position of a read in the footer, or size() if not found.
+    size_t
+    find(std::string const & read_id) const
+    {
+        size_t lo = 0;
+        size_t hi = size();
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            if (std::strcmp(pool_string(disk_entry(mid).read_id_offset), read_id.c_str()) < 0)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        if (lo == size() or read_id != pool_string(disk_entry(lo).read_id_offset)) return size();
+        return lo;
+    } // find()
+
+    Record_View
+    parse_record(std::string const & read_id) const
+    {
+        auto i = find(read_id);
+        if (i == size())
+        {
+            LOG_THROW
+                << _file_name << ": read not found in pack archive: read_id=" << read_id;
+        }
+        auto de = disk_entry(i);
+        Cursor c(_data + de.record_offset, _data + de.record_offset + de.record_size);
+        Record_View res;
+        res.read_id = c.get_string();
+        res.channel_id_params.channel_number = c.get_string();
+        res.channel_id_params.digitisation = c.get< double >();
+        res.channel_id_params.offset = c.get< double >();
+        res.channel_id_params.range = c.get< double >();
+        res.channel_id_params.sampling_rate = c.get< double >();
+        res.have_raw_samples = c.get< std::uint8_t >();
+        if (res.have_raw_samples)
+        {
+            res.raw_samples_read_name = c.get_string();
+            res.raw_samples_params.read_id = c.get_string();
+            res.raw_samples_params.read_number = c.get< std::int64_t >();
+            res.raw_samples_params.start_mux = c.get< std::int64_t >();
+            res.raw_samples_params.start_time = c.get< std::int64_t >();
+            res.raw_samples_params.duration = c.get< std::int64_t >();
+            res.signal = c.get_code();
+        }
+        auto num_fq = c.get< std::uint32_t >();
+        for (std::uint32_t j = 0; j < num_fq; ++j)
+        {
+            Fastq_View fv;
+            fv.st = c.get< std::uint8_t >();
+            fv.gr = c.get_string();
+            fv.read_name = c.get_string();
+            fv.qv_bits = c.get< std::uint8_t >();
+            fv.bp = c.get_code();
+            fv.qv = c.get_code();
+            res.basecall_fastq_l.push_back(std::move(fv));
+        }
+        if (res.read_id != read_id)
+        {
+            LOG_THROW
+                << _file_name << ": corrupt pack archive record: read_id=" << read_id;
+        }
+        return res;
+    } // parse_record()
+    Record_View
+    parse_raw_record(std::string const & read_id) const
+    {
+        auto res = parse_record(read_id);
+        if (not res.have_raw_samples)
+        {
+            LOG_THROW
+                << _file_name << ": raw samples not found: read_id=" << read_id;
+        }
+        return res;
+    }
+    static Fastq_View const *
+    find_fastq(Record_View const & rv, unsigned st, std::string const & gr)
+    {
+        for (auto const & fv : rv.basecall_fastq_l)
+        {
+            if (fv.st == st and fv.gr == gr) return &fv;
+        }
+        return nullptr;
+    }
+}; // class Pack_Archive
+
+/**
+ * Writer of pack archives. Records are only ever appended: reopening an existing archive
+ * keeps its records, and the footer is rewritten on close().
+ */
+class Pack_Archive_Writer
+{
+public:
+    Pack_Archive_Writer() : _end(0) {}
+    Pack_Archive_Writer(Pack_Archive_Writer const &) = delete;
+    Pack_Archive_Writer & operator = (Pack_Archive_Writer const &) = delete;
+    ~Pack_Archive_Writer()
+    {
+        try
+        {
+            close();
+        }
+        catch (std::exception & e)
+        {
+            LOG(error) << e.what() << std::endl;
+        }
+    }
+
+    bool is_open() const { return _ofs.is_open(); }
+    std::string const & file_name() const { return _file_name; }
+    /// Number of reads in the archive, including the ones it held when opened.
+    size_t size() const { return _entry_m.size(); }
+    bool have_read(std::string const & read_id) const { return _entry_m.count(read_id) > 0; }
+
+    /**
+     * Create a new archive.
+     * @param fn Archive file.
+     * @param truncate If true, overwrite the file if it exists; otherwise, fail.
+     */
+    void
+    create(std::string const & fn, bool truncate = false)
+    {
+        close();
+        struct stat st;
+        if (not truncate and stat(fn.c_str(), &st) == 0)
+        {
+            LOG_THROW
+                << fn << ": pack archive exists";
+        }
+        _ofs.open(fn, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (not _ofs)
+        {
+            LOG_THROW
+                << fn << ": error creating pack archive";
+        }
+        _file_name = fn;
+        _ofs.write(Pack_Archive::magic(), Pack_Archive::header_size());
+        _end = Pack_Archive::header_size();
+    } // create()
+    /**
+     * Open an existing archive, to append reads to it.
+     * New records overwrite the old footer only.
+     * @param fn Archive file.
+     */
+    void
+    open(std::string const & fn)
+    {
+        close();
+        {
+            Pack_Archive ar(fn);
+            for (size_t i = 0; i < ar.size(); ++i)
+            {
+                auto de = ar.disk_entry(i);
+                _entry_m.emplace(ar.pool_string(de.read_id_offset), std::make_pair(de.record_offset, de.record_size));
+            }
+            _end = ar.trailer().footer_offset;
+        }
+        _ofs.open(fn, std::ios::binary | std::ios::in | std::ios::out);
+        if (not _ofs or not _ofs.seekp(_end))
+        {
+            _entry_m.clear();
+            LOG_THROW
+                << fn << ": error opening pack archive";
+        }
+        _file_name = fn;
+    } // open()
+    /// Write the footer, and close the archive.
+    void
+    close()
+    {
+        if (not is_open()) return;
+        std::string footer;
+        std::string pool;
+        for (auto const & p : _entry_m)
+        {
+            Pack_Archive::Disk_Entry de;
+            de.read_id_offset = pool.size();
+            de.record_offset = p.second.first;
+            de.record_size = p.second.second;
+            footer.append(reinterpret_cast< char const * >(&de), sizeof(de));
+            pool.append(p.first.c_str(), p.first.size() + 1);
+        }
+        footer += pool;
+        Pack_Archive::Trailer t;
+        t.footer_offset = _end;
+        t.num_entries = _entry_m.size();
+        t.pool_size = pool.size();
+        std::memcpy(t.magic, Pack_Archive::magic(), sizeof(t.magic));
+        footer.append(reinterpret_cast< char const * >(&t), sizeof(t));
+        _ofs.write(footer.data(), footer.size());
+        bool ok = static_cast< bool >(_ofs);
+        _ofs.close();
+        _entry_m.clear();
+        _end = 0;
+        auto fn = std::move(_file_name);
+        _file_name.clear();
+        if (not ok)
+        {
+            LOG_THROW
+                << fn << ": error writing pack archive footer";
+        }
+    } // close()
+
+    /**
+     * Append a read.
+     * @param r Read; its read id must not be in the archive.
+     */
+    void
+    add_read(Pack_Archive::Read const & r)
+    {
+        assert(is_open());
+        if (r.read_id.empty() or have_read(r.read_id))
+        {
+            LOG_THROW
+                << _file_name << ": " << (r.read_id.empty()? "empty" : "duplicate") << " read id: " << r.read_id;
+        }
+        auto rec = Pack_Archive::make_record(r);
+        if (not _ofs.write(rec.data(), rec.size()))
+        {
+            LOG_THROW
+                << _file_name << ": error writing pack archive";
+        }
+        _entry_m.emplace(r.read_id, std::make_pair(_end, rec.size()));
+        _end += rec.size();
+    } // add_read()
+
+private:
+    std::string _file_name;
+    std::fstream _ofs;
+    // offset where the next record is written
+    std::uint64_t _end;
+    // read id -> (record offset, record size)
+    std::map< std::string, std::pair< std::uint64_t, std::uint64_t > > _entry_m;
+}; // class Pack_Archive_Writer
+
+} // namespace fast5
+
+#endif
@@ -0,0 +1,196 @@
+//
+// Part of: https://github.com/mateidavid/fast5
+//
+// Copyright (c) 2015-2017 Matei David, Ontario Institute for Cancer Research
+// MIT License
+//
+
+#ifndef __RAW_SAMPLES_WRITER_HPP
+#define __RAW_SAMPLES_WRITER_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "fast5.hpp"
+#include "logger.hpp"
+
+namespace fast5
+{
+
+/**
+ * Streaming writer of raw samples, for reads whose signal arrives in chunks.
+ *
+ * The Signal dataset is created empty, chunked and extendible, and each append() extends it,
+ * so memory use does not depend on read length. If packing, each appended chunk is Huffman
+ * coded on its own and appended to the Signal_Pack code; the coder restarts from an absolute
+ * value after every chunk, so the concatenated code decodes as one.
+ *
+ * All objects are created by open(), and the raw samples params are written with a duration
+ * of 0, which close() updates to the number of samples appended. So once a writer is open,
+ * the file can be switched to SWMR mode with File::start_swmr_write(); every append() then
+ * flushes the file, and SWMR readers see the new samples after File::refresh(). The packed
+ * signal size attributes cannot be added in SWMR mode, so they are only written otherwise.
+ */
+class Raw_Samples_Writer
+{
+public:
+    Raw_Samples_Writer() : _f(nullptr), _pack(false), _num_samples(0), _code_size(0) {}
+    /// Same as open().
+    Raw_Samples_Writer(File & f, std::string const & rn, Raw_Samples_Params const & params,
+                       bool pack = false, size_t chunk_size = default_chunk_size())
+        : Raw_Samples_Writer()
+    {
+        open(f, rn, params, pack, chunk_size);
+    }
+    Raw_Samples_Writer(Raw_Samples_Writer const &) = delete;
+    Raw_Samples_Writer & operator = (Raw_Samples_Writer const &) = delete;
+    ~Raw_Samples_Writer()
+    {
+        try
+        {
+            close();
+        }
+        catch (std::exception & e)
+        {
+            LOG(error) << e.what() << std::endl;
+        }
+    }
+
+    bool is_open() const { return _f != nullptr; }
+    /// Number of samples appended so far.
+    long long size() const { return _num_samples; }
+
+    /**
+     * Start writing the raw samples of a read.
+     * @param f Destination file, or read view, open for writing; it must outlive the writer.
+     * @param rn Raw read name; ignored in read views.
+     * @param params Raw samples params; the duration is updated on close().
+     * @param pack If true, write packed raw samples.
+     * @param chunk_size Dataset chunk size, in samples if not packing, in bytes if packing.
+     */
+    void
+    open(File & f, std::string const & rn, Raw_Samples_Params const & params,
+         bool pack = false, size_t chunk_size = default_chunk_size())
+    {
+        close();
+        assert(f.is_open() and f.is_rw());
+        if (not f.is_read_view() and rn.empty())
+        {
+            LOG_THROW
+                << f.file_name() << ": missing raw read name";
+        }
+        if (f.is_read_view()? f.have_raw_samples() : f.have_raw_samples(rn))
+        {
+            LOG_THROW
+                << f.file_name() << ": raw samples exist: rn=" << rn;
+        }
+        _f = &f;
+        _rn = rn;
+        _params = params;
+        _params.duration = 0;
+        _pack = pack;
+        _num_samples = 0;
+        _code_size = 0;
+        if (pack)
+        {
+            f.Base::create_extendible_dataset< std::uint8_t >(signal_path(f), chunk_size);
+            // all chunk codes share the coder params, except for their size stats
+            auto code_params = File::rw_coder().encode(std::vector< Raw_Int_Sample >(1), true).second;
+            code_params.erase("size");
+            code_params.erase("avg_bits");
+            f.Base::add_attr_map(signal_path(f), code_params);
+            _params.write(f, f.raw_samples_params_pack_path(rn));
+        }
+        else
+        {
+            f.Base::create_extendible_dataset< Raw_Int_Sample >(signal_path(f), chunk_size);
+            f.add_raw_samples_params(rn, _params);
+        }
+    } // open()
+
+    /**
+     * Append raw samples.
+     * @param rsi Source address.
+     * @param n Number of samples.
+     */
+    void
+    append(Raw_Int_Sample const * rsi, size_t n)
+    {
+        assert(is_open());
+        if (n == 0) return;
+        if (_pack)
+        {
+            auto code = File::rw_coder().encode(std::vector< Raw_Int_Sample >(rsi, rsi + n), true);
+            _f->Base::append_dataset(signal_path(*_f), code.first.data(), code.first.size());
+            _code_size += code.first.size();
+        }
+        else
+        {
+            _f->Base::append_dataset(signal_path(*_f), rsi, n);
+        }
+        _num_samples += n;
+        if (_f->is_swmr()) _f->flush();
+    } // append()
+    void
+    append(std::vector< Raw_Int_Sample > const & rsi)
+    {
+        append(rsi.data(), rsi.size());
+    }
+
+    /// Update the duration in the raw samples params, and add the read to the file.
+    void
+    close()
+    {
+        if (not is_open()) return;
+        auto f = _f;
+        _f = nullptr;
+        _params.duration = _num_samples;
+        if (_pack)
+        {
+            f->Base::update_attribute(f->raw_samples_params_pack_path(_rn) + "/duration", _params.duration);
+            if (not f->is_swmr())
+            {
+                Attr_Map code_params;
+                std::ostringstream oss;
+                oss << _num_samples;
+                code_params["size"] = oss.str();
+                oss.str("");
+                oss << std::fixed << std::setprecision(2)
+                    << (_num_samples > 0? (double)(_code_size * 8) / _num_samples : 0.0);
+                code_params["avg_bits"] = oss.str();
+                f->Base::add_attr_map(signal_path(*f), code_params);
+            }
+        }
+        else
+        {
+            f->Base::update_attribute(f->raw_samples_params_path(_rn) + "/duration", _params.duration);
+        }
+        if (f->is_swmr()) f->flush();
+        f->update_raw_samples_read_name(_rn);
+    } // close()
+
+    static size_t default_chunk_size() { return 1u << 16; }
+
+private:
+    File * _f;
+    std::string _rn;
+    Raw_Samples_Params _params;
+    bool _pack;
+    long long _num_samples;
+    // packing: total code size
+    size_t _code_size;
+
+    std::string signal_path(File const & f) const
+    {
+        return _pack? f.raw_samples_pack_path(_rn) + "/Signal" : f.raw_samples_path(_rn);
+    }
+}; // class Raw_Samples_Writer
+
+} // namespace fast5
+
+#endif
@@ -0,0 +1,550 @@
+//
+// Part of: https://github.com/mateidavid/fast5
+//
+// Copyright (c) 2015-2017 Matei David, Ontario Institute for Cancer Research
+// MIT License
+//
+
+#ifndef __READ_INDEX_HPP
+#define __READ_INDEX_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "fast5.hpp"
+#include "logger.hpp"
+
+namespace fast5
+{
+
+/**
+ * Index of the reads held by many fast5 files, for direct lookup by read id.
+ * Each read is recorded with the file holding it, the internal path of its raw samples, whether
+ * these are packed, the number of samples, the channel, and the start time.
+ *
+ * The index is kept as one flat image, which is also its file format: a header, a table of
+ * fixed size entries sorted by read id, a table of file names, and a pool of null-terminated
+ * strings referred to by offset. Lookups binary search the image in place, so loading an index
+ * is a single read, and the image can equally be memory-mapped. Integers are stored in host
+ * byte order.
+ */
+class Read_Index
+{
+public:
+    /// Index entry
+    struct Entry
+    {
+        std::string read_id;
+        std::string file_name;
+        // raw read name; in multi-read files, the read id
+        std::string read_name;
+        // internal path of the raw samples dataset, or of its pack group
+        std::string path;
+        bool packed;
+        bool multi_read;
+        long long num_samples;
+        std::string channel_number;
+        long long start_time;
+
+        Entry() : packed(false), multi_read(false), num_samples(0), start_time(0) {}
+    }; // struct Entry
+
+    /**
+     * An indexed read, opened with open_read(): the file holding it and, for a multi-read
+     * file, a view of the read in that file.
+     */
+    class Open_Read
+    {
+    public:
+        /// Object accessing the read.
+        File const & file() const { return _view.is_open()? _view : _file; }
+        /// Raw read name of the read, to pass to the raw samples accessors of file().
+        std::string const & read_name() const { return _read_name; }
+        void close()
+        {
+            _view.close();
+            _file.close();
+        }
+    private:
+        friend class Read_Index;
+        File _file;
+        // declared after _file, so that it is closed first
+        File _view;
+        std::string _read_name;
+    }; // class Open_Read
+
+    /// Number of reads in the index.
+    size_t size() const { return _image.empty()? 0 : header().num_entries; }
+
+    /**
+     * Build the index of the reads in a list of fast5 files.
+     * Files are scanned in parallel, reading only their metadata and raw samples attributes.
+     * If a read id is found in several files, the first file in @p fn_l is indexed, and the
+     * others are reported as errors.
+     * @param fn_l List of fast5 files.
+     * @param num_threads Number of files to scan in parallel.
+     * @return List of (index in @p fn_l, error message), sorted by index.
+     */
+    std::vector< std::pair< size_t, std::string > >
+    build(std::vector< std::string > const & fn_l, unsigned num_threads)
+    {
+        num_threads = std::max(1u, std::min< unsigned >(num_threads, fn_l.size()));
+        std::vector< std::vector< Entry > > entry_v(fn_l.size());
+        std::vector< std::vector< std::pair< size_t, std::string > > > err_v(num_threads);
+        std::atomic< size_t > next(0);
+        auto worker = [&] (unsigned tid) {
+            for (size_t i = next++; i < fn_l.size(); i = next++)
+            {
+                try
+                {
+                    entry_v[i] = scan_file(fn_l[i]);
+                }
+                catch (hdf5_tools::Exception & e)
+                {
+                    err_v[tid].emplace_back(i, fn_l[i] + ": HDF5 error: " + e.what());
+                }
+                catch (std::exception & e)
+                {
+                    err_v[tid].emplace_back(i, e.what());
+                }
+            }
+        };
+        std::vector< std::thread > thread_v;
+        for (unsigned tid = 1; tid < num_threads; ++tid)
+        {
+            thread_v.emplace_back(worker, tid);
+        }
+        worker(0);
+        for (auto & t : thread_v)
+        {
+            t.join();
+        }
+        std::vector< std::pair< size_t, std::string > > res;
+        for (auto const & err_l : err_v)
+        {
+            res.insert(res.end(), err_l.begin(), err_l.end());
+        }
+        // sort entries by read id, then by file index; drop duplicates
+        std::vector< Entry const * > entry_ptr_l;
+        std::vector< size_t > file_idx_l;
+        for (size_t i = 0; i < entry_v.size(); ++i)
+        {
+            for (auto const & e : entry_v[i])
+            {
+                entry_ptr_l.push_back(&e);
+                file_idx_l.push_back(i);
+            }
+        }
+        std::vector< size_t > order(entry_ptr_l.size());
+        for (size_t j = 0; j < order.size(); ++j) order[j] = j;
+        std::stable_sort(order.begin(), order.end(), [&] (size_t lhs, size_t rhs) {
+                return entry_ptr_l[lhs]->read_id < entry_ptr_l[rhs]->read_id;
+            });
+        std::vector< Entry const * > sorted_l;
+        for (auto j : order)
+        {
+            if (not sorted_l.empty() and sorted_l.back()->read_id == entry_ptr_l[j]->read_id)
+            {
+                res.emplace_back(file_idx_l[j], "duplicate read id: " + entry_ptr_l[j]->read_id
+                                 + ", also in " + sorted_l.back()->file_name);
+                continue;
+            }
+            sorted_l.push_back(entry_ptr_l[j]);
+        }
+        make_image(sorted_l);
+        std::sort(res.begin(), res.end());
+        return res;
+    } // build()
+
+    /**
+     * Load index from file.
+     * @param fn Index file.
+     */
+    void
+    load(std::string const & fn)
+    {
+        std::ifstream ifs(fn, std::ios::binary | std::ios::ate);
+        if (not ifs)
+        {
+            LOG_THROW
+                << fn << ": error opening index";
+        }
+        std::vector< char > image(static_cast< size_t >(ifs.tellg()));
+        ifs.seekg(0);
+        if (not ifs.read(image.data(), image.size()))
+        {
+            LOG_THROW
+                << fn << ": error reading index";
+        }
+        if (not is_valid_image(image))
+        {
+            LOG_THROW
+                << fn << ": not a valid read index";
+        }
+        _image.swap(image);
+    } // load()
+    /**
+     * Save index to file.
+     * @param fn Index file; overwritten if it exists.
+     */
+    void
+    save(std::string const & fn) const
+    {
+        std::ofstream ofs(fn, std::ios::binary);
+        if (not ofs.write(_image.data(), _image.size()))
+        {
+            LOG_THROW
+                << fn << ": error writing index";
+        }
+    } // save()
+
+    /**
+     * Look up a read.
+     * @param read_id Read id.
+     * @param e Destination entry.
+     * @return True iff the read was found.
+     */
+    bool
+    find(std::string const & read_id, Entry & e) const
+    {
+        size_t lo = 0;
+        size_t hi = size();
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            if (std::strcmp(pool_string(disk_entry(mid).read_id_offset), read_id.c_str()) < 0)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        if (lo == size() or read_id != pool_string(disk_entry(lo).read_id_offset)) return false;
+        e = get_entry(lo);
+        return true;
+    } // find()
+    /**
+     * Get an entry by position; entries are sorted by read id.
+     * @param i Position, less than size().
+     */
+    Entry
+    get_entry(size_t i) const
+    {
+        assert(i < size());
+        auto de = disk_entry(i);
+        Entry res;
+        res.read_id = pool_string(de.read_id_offset);
+        res.file_name = pool_string(file_name_offset(de.file_index));
+        res.read_name = pool_string(de.read_name_offset);
+        res.path = pool_string(de.path_offset);
+        res.packed = de.flags & packed_flag;
+        res.multi_read = de.flags & multi_read_flag;
+        res.num_samples = de.num_samples;
+        res.channel_number = pool_string(de.channel_number_offset);
+        res.start_time = de.start_time;
+        return res;
+    } // get_entry()
+
+    /**
+     * Open an indexed read.
+     * @param read_id Read id.
+     * @param r Destination; any read it holds is closed first.
+     * @param flags Open flags of the fast5 file.
+     */
+    void
+    open_read(std::string const & read_id, Open_Read & r, unsigned flags = File::open_all) const
+    {
+        Entry e;
+        if (not find(read_id, e))
+        {
+            LOG_THROW
+                << "read not found in index: read_id=" << read_id;
+        }
+        r.close();
+        r._file.open(e.file_name, false, flags);
+        if (e.multi_read) r._view.open_read(r._file, read_id, flags);
+        r._read_name = e.read_name;
+    } // open_read()
+
+    /**
+     * Scan one fast5 file, single-read or multi-read, for indexed reads.
+     * @param fn Fast5 file.
+     * @return Entries of the reads with raw samples, in file order.
+     */
+    static std::vector< Entry >
+    scan_file(std::string const & fn)
+    {
+        std::vector< Entry > res;
+        File f(fn, false, File::open_raw_only);
+        auto add_entry = [&] (File const & rf, std::string const & rn, bool multi_read) {
+            Entry e;
+            auto params = rf.get_raw_samples_params(rn);
+            e.read_id = multi_read? rf.get_read_id() : params.read_id;
+            if (e.read_id.empty())
+            {
+                LOG_THROW
+                    << fn << ": read id not found: rn=" << rn;
+            }
+            e.file_name = fn;
+            e.read_name = rn;
+            e.packed = rf.have_raw_samples_pack(rn);
+            e.path = e.packed? rf.raw_samples_pack_path(rn) : rf.raw_samples_path(rn);
+            e.multi_read = multi_read;
+            e.num_samples = params.duration;
+            e.channel_number = rf.get_channel_id_params().channel_number;
+            e.start_time = params.start_time;
+            res.push_back(std::move(e));
+        };
+        if (f.is_multi_read())
+        {
+            for (auto const & read_id : f.get_read_id_list())
+            {
+                File rf;
+                rf.open_read(f, read_id, File::open_raw_only);
+                if (rf.have_raw_samples()) add_entry(rf, read_id, true);
+            }
+        }
+        else
+        {
+            for (auto const & rn : f.get_raw_samples_read_name_list())
+            {
+                add_entry(f, rn, false);
+            }
+        }
+        return res;
+    } // scan_file()
+
+    /**
+     * Find fast5 files, by name suffix.
+     * @param path_l List of directories and files; files are taken as given.
+     * @param recurse Flag: recurse in subdirectories.
+     * @return List of files; files found in each directory are sorted by name.
+     */
+    static std::vector< std::string >
+    find_files(std::vector< std::string > const & path_l, bool recurse)
+    {
+        std::vector< std::string > res;
+        for (auto const & p : path_l)
+        {
+            if (is_dir(p))
+            {
+                add_dir(res, p, recurse);
+            }
+            else
+            {
+                res.push_back(p);
+            }
+        }
+        return res;
+    } // find_files()
+
+    static std::string const & file_suffix() { static std::string const _file_suffix = ".fast5"; return _file_suffix; }
+
+private:
+    std::vector< char > _image;
+
+    static char const * magic() { return "F5RIDX01"; }
+    enum Entry_Flags { packed_flag = 1, multi_read_flag = 2 };
+
+    //
+    // Image layout: Header, Disk_Entry[num_entries], file name offsets (uint64_t[num_files]), string pool
+    //
+    struct Header
+    {
+        char magic[8];
+        std::uint64_t num_entries;
+        std::uint64_t num_files;
+        std::uint64_t pool_size;
+    }; // struct Header
+    struct Disk_Entry
+    {
+        std::uint64_t read_id_offset;
+        std::uint64_t read_name_offset;
+        std::uint64_t path_offset;
+        std::uint64_t channel_number_offset;
+        std::int64_t num_samples;
+        std::int64_t start_time;
+        std::uint32_t file_index;
+        std::uint32_t flags;
+    }; // struct Disk_Entry
+
+    Header header() const
+    {
+        Header res;
+        std::memcpy(&res, _image.data(), sizeof(Header));
+        return res;
+    }
+    size_t files_offset() const { return sizeof(Header) + header().num_entries * sizeof(Disk_Entry); }
+    size_t pool_offset() const { return files_offset() + header().num_files * sizeof(std::uint64_t); }
+    Disk_Entry disk_entry(size_t i) const
+    {
+        Disk_Entry res;
+        std::memcpy(&res, _image.data() + sizeof(Header) + i * sizeof(Disk_Entry), sizeof(Disk_Entry));
+        return res;
+    }
+    std::uint64_t file_name_offset(size_t i) const
+    {
+        std::uint64_t res;
+        std::memcpy(&res, _image.data() + files_offset() + i * sizeof(std::uint64_t), sizeof(std::uint64_t));
+        return res;
+    }
+    char const * pool_string(std::uint64_t offset) const
+    {
+        return _image.data() + pool_offset() + offset;
+    }
+
+    /// Check image size and offsets, so that lookups stay within the image.
+    static bool
+    is_valid_image(std::vector< char > const & image)
+    {
+        Header h;
+        if (image.size() < sizeof(Header)) return false;
+        std::memcpy(&h, image.data(), sizeof(Header));
+        if (std::memcmp(h.magic, magic(), sizeof(h.magic)) != 0) return false;
+        // guard against overflow before checking the total size
+        if (h.num_entries > image.size() / sizeof(Disk_Entry)
+            or h.num_files > image.size() / sizeof(std::uint64_t)
+            or h.pool_size > image.size()) return false;
+        size_t pool_offset = sizeof(Header) + h.num_entries * sizeof(Disk_Entry) + h.num_files * sizeof(std::uint64_t);
+        if (pool_offset + h.pool_size != image.size()) return false;
+        if (h.pool_size == 0 or image.back() != '\0') return false;
+        for (size_t i = 0; i < h.num_entries; ++i)
+        {
+            Disk_Entry de;
+            std::memcpy(&de, image.data() + sizeof(Header) + i * sizeof(Disk_Entry), sizeof(Disk_Entry));
+            if (de.read_id_offset >= h.pool_size or de.read_name_offset >= h.pool_size
+                or de.path_offset >= h.pool_size or de.channel_number_offset >= h.pool_size
+                or de.file_index >= h.num_files) return false;
+        }
+        for (size_t i = 0; i < h.num_files; ++i)
+        {
+            std::uint64_t offset;
+            std::memcpy(&offset, image.data() + sizeof(Header) + h.num_entries * sizeof(Disk_Entry)
+                        + i * sizeof(std::uint64_t), sizeof(std::uint64_t));
+            if (offset >= h.pool_size) return false;
+        }
+        return true;
+    } // is_valid_image()
+
+    /**
+     * Make the index image.
+     * Only the files holding some entry are stored.
+     * @param entry_l Entries, sorted by read id.
+     */
+    void
+    make_image(std::vector< Entry const * > const & entry_l)
+    {
+        // string pool, with repeated strings (e.g. channel numbers) stored once
+        std::string pool;
+        std::unordered_map< std::string, std::uint64_t > pool_m;
+        auto add_string = [&] (std::string const & s) {
+            auto it = pool_m.find(s);
+            if (it != pool_m.end()) return it->second;
+            std::uint64_t offset = pool.size();
+            pool.append(s.c_str(), s.size() + 1);
+            pool_m[s] = offset;
+            return offset;
+        };
+        std::unordered_map< std::string, std::uint32_t > file_index_m;
+        std::vector< std::uint64_t > file_offset_l;
+        std::vector< Disk_Entry > disk_entry_l;
+        disk_entry_l.reserve(entry_l.size());
+        for (auto e_ptr : entry_l)
+        {
+            auto const & e = *e_ptr;
+            Disk_Entry de;
+            de.read_id_offset = add_string(e.read_id);
+            de.read_name_offset = add_string(e.read_name);
+            de.path_offset = add_string(e.path);
+            de.channel_number_offset = add_string(e.channel_number);
+            de.num_samples = e.num_samples;
+            de.start_time = e.start_time;
+            auto it = file_index_m.find(e.file_name);
+            if (it == file_index_m.end())
+            {
+                it = file_index_m.emplace(e.file_name, file_offset_l.size()).first;
+                file_offset_l.push_back(add_string(e.file_name));
+            }
+            de.file_index = it->second;
+            de.flags = (e.packed? packed_flag : 0) | (e.multi_read? multi_read_flag : 0);
+            disk_entry_l.push_back(de);
+        }
+        if (pool.empty()) pool.push_back('\0');
+        Header h;
+        std::memcpy(h.magic, magic(), sizeof(h.magic));
+        h.num_entries = disk_entry_l.size();
+        h.num_files = file_offset_l.size();
+        h.pool_size = pool.size();
+        std::vector< char > image(sizeof(Header) + h.num_entries * sizeof(Disk_Entry)
+                                  + h.num_files * sizeof(std::uint64_t) + h.pool_size);
+        char * p = image.data();
+        std::memcpy(p, &h, sizeof(Header));
+        p += sizeof(Header);
+        if (not disk_entry_l.empty()) std::memcpy(p, disk_entry_l.data(), disk_entry_l.size() * sizeof(Disk_Entry));
+        p += disk_entry_l.size() * sizeof(Disk_Entry);
+        if (not file_offset_l.empty()) std::memcpy(p, file_offset_l.data(), file_offset_l.size() * sizeof(std::uint64_t));
+        p += file_offset_l.size() * sizeof(std::uint64_t);
+        std::memcpy(p, pool.data(), pool.size());
+        _image.swap(image);
+    } // make_image()
+
+    static bool
+    is_dir(std::string const & p)
+    {
+        struct stat st;
+        return stat(p.c_str(), &st) == 0 and S_ISDIR(st.st_mode);
+    }
+    static void
+    add_dir(std::vector< std::string > & l, std::string const & dn, bool recurse)
+    {
+        DIR * dir_ptr = opendir(dn.c_str());
+        if (not dir_ptr)
+        {
+            LOG(warning) << "error opening directory: " << dn << std::endl;
+            return;
+        }
+        std::vector< std::string > name_l;
+        while (auto ent_ptr = readdir(dir_ptr))
+        {
+            std::string name = ent_ptr->d_name;
+            if (name != "." and name != "..") name_l.push_back(name);
+        }
+        closedir(dir_ptr);
+        std::sort(name_l.begin(), name_l.end());
+        std::vector< std::string > subdir_l;
+        for (auto const & name : name_l)
+        {
+            auto fn = dn + "/" + name;
+            if (is_dir(fn))
+            {
+                subdir_l.push_back(fn);
+            }
+            else if (name.size() > file_suffix().size()
+                     and name.compare(name.size() - file_suffix().size(), file_suffix().size(), file_suffix()) == 0)
+            {
+                l.push_back(fn);
+            }
+        }
+        if (not recurse) return;
+        for (auto const & sdn : subdir_l)
+        {
+            add_dir(l, sdn, recurse);
+        }
+    }
+}; // class Read_Index
+
+} // namespace fast5
+
+#endif
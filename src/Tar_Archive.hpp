@@ -0,0 +1,435 @@
+//
+// Part of: https://github.com/mateidavid/fast5
+//
+// Copyright (c) 2015-2017 Matei David, Ontario Institute for Cancer Research
+// MIT License
+//
+
+#ifndef __TAR_ARCHIVE_HPP
+#define __TAR_ARCHIVE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fast5.hpp"
+#include "logger.hpp"
+
+namespace fast5
+{
+
+/**
+ * Read-only access to the fast5 files stored in a tar archive, without extracting them.
+ *
+ * On open, the archive is indexed once: only the member headers are read, and the data is
+ * skipped, so that the index maps each member name to the offset and size of its data.
+ * A member is then opened as a File by reading its data with a single read, and passing it
+ * to HDF5 as an in-memory file image. Alternatively, stream() visits all members in one
+ * sequential pass, which also works on pipes and needs no index.
+ *
+ * Members are the regular files with a name ending in ".fast5"; other entries are skipped.
+ * The ustar, pax (path and size records), and GNU (long names, base-256 sizes) formats are
+ * supported.
+ */
+class Tar_Archive
+{
+public:
+    /// One fast5 file in the archive.
+    struct Member
+    {
+        std::string name;
+        // offset and size of the member data in the archive
+        std::uint64_t offset;
+        std::uint64_t size;
+    }; // struct Member
+
+    Tar_Archive() : _fd(-1) {}
+    Tar_Archive(std::string const & fn) : Tar_Archive() { open(fn); }
+    Tar_Archive(Tar_Archive const &) = delete;
+    Tar_Archive & operator = (Tar_Archive const &) = delete;
+    ~Tar_Archive() { close(); }
+
+    bool is_open() const { return _fd >= 0; }
+    std::string const & file_name() const { return _file_name; }
+
+    /**
+     * Open and index an archive.
+     * @param fn Tar file.
+     */
+    void
+    open(std::string const & fn)
+    {
+        close();
+        _fd = ::open(fn.c_str(), O_RDONLY);
+        if (_fd < 0)
+        {
+            LOG_THROW
+                << fn << ": error opening tar archive";
+        }
+        _file_name = fn;
+        try
+        {
+            struct stat st;
+            if (fstat(_fd, &st) != 0)
+            {
+                LOG_THROW
+                    << fn << ": error opening tar archive";
+            }
+            std::uint64_t pos = 0;
+            auto read_fcn = [&] (char * buf, size_t n) {
+                if (not pread_all(buf, n, pos)) return false;
+                pos += n;
+                return true;
+            };
+            auto skip_fcn = [&] (std::uint64_t n) { pos += n; };
+            scan(fn, read_fcn, skip_fcn, [&] (Member const & m) {
+                    if (m.offset + m.size > static_cast< std::uint64_t >(st.st_size))
+                    {
+                        LOG_THROW
+                            << fn << ": truncated tar archive";
+                    }
+                    if (_member_m.count(m.name))
+                    {
+                        // a later copy of a file replaces an earlier one, as with tar -x
+                        _member_l[_member_m.at(m.name)] = m;
+                    }
+                    else
+                    {
+                        _member_m[m.name] = _member_l.size();
+                        _member_l.push_back(m);
+                    }
+                    pos += m.size;
+                });
+        }
+        catch (...)
+        {
+            close();
+            throw;
+        }
+    } // open()
+    void
+    close()
+    {
+        if (not is_open()) return;
+        ::close(_fd);
+        _fd = -1;
+        _file_name.clear();
+        _member_l.clear();
+        _member_m.clear();
+    } // close()
+
+    /// Number of members.
+    size_t size() const { return _member_l.size(); }
+    /// Member, by index in archive order.
+    Member const & get_member(size_t i) const { return _member_l.at(i); }
+    /// Member names, in archive order.
+    std::vector< std::string >
+    get_member_list() const
+    {
+        std::vector< std::string > res;
+        res.reserve(size());
+        for (auto const & m : _member_l)
+        {
+            res.push_back(m.name);
+        }
+        return res;
+    }
+    bool
+    have_member(std::string const & name) const
+    {
+        return _member_m.count(name) > 0;
+    }
+    Member const &
+    get_member(std::string const & name) const
+    {
+        auto it = _member_m.find(name);
+        if (it == _member_m.end())
+        {
+            LOG_THROW
+                << _file_name << ": member not found: " << name;
+        }
+        return _member_l[it->second];
+    }
+
+    /**
+     * Read the data of a member.
+     * @param name Member name.
+     */
+    std::vector< char >
+    read_member(std::string const & name) const
+    {
+        auto const & m = get_member(name);
+        std::vector< char > res(m.size);
+        if (not pread_all(res.data(), res.size(), m.offset))
+        {
+            LOG_THROW
+                << _file_name << ": error reading member: " << name;
+        }
+        return res;
+    }
+    /**
+     * Open a member as a read-only fast5 file, through an in-memory file image.
+     * @param name Member name.
+     * @param f Destination file object.
+     * @param flags Open flags, as for File::open().
+     */
+    void
+    open_member(std::string const & name, File & f, unsigned flags = File::open_all) const
+    {
+        f.open_image(read_member(name), member_file_name(_file_name, name), flags);
+    }
+
+    /**
+     * Visit all members, in archive order, in one sequential pass over the archive.
+     * @param cb Callback, called as cb(Member const &, File &) with each member open.
+     * @param flags Open flags, as for File::open().
+     * @return Number of members visited.
+     */
+    template < typename Callback >
+    size_t
+    for_each_member(Callback && cb, unsigned flags = File::open_all) const
+    {
+        std::ifstream ifs(_file_name, std::ios::binary);
+        if (not ifs)
+        {
+            LOG_THROW
+                << _file_name << ": error opening tar archive";
+        }
+        return stream(ifs, _file_name, std::forward< Callback >(cb), flags);
+    }
+    /**
+     * Visit all members of a tar stream, in one sequential pass, without an index.
+     * Member data is read into a buffer reused across members, and the stream is never
+     * rewound, so it can be a pipe.
+     * @param is Input stream.
+     * @param fn Archive name, for file names and error messages.
+     * @param cb Callback, called as cb(Member const &, File &) with each member open.
+     * @param flags Open flags, as for File::open().
+     * @return Number of members visited.
+     */
+    template < typename Callback >
+    static size_t
+    stream(std::istream & is, std::string const & fn, Callback && cb, unsigned flags = File::open_all)
+    {
+        size_t cnt = 0;
+        std::vector< char > buf;
+        auto read_fcn = [&] (char * p, size_t n) {
+            return static_cast< bool >(is.read(p, n));
+        };
+        auto skip_fcn = [&] (std::uint64_t n) {
+            is.ignore(n);
+        };
+        scan(fn, read_fcn, skip_fcn, [&] (Member const & m) {
+                buf.resize(m.size);
+                if (not read_fcn(buf.data(), buf.size()))
+                {
+                    LOG_THROW
+                        << fn << ": truncated tar archive";
+                }
+                File f;
+                f.open_image(buf, member_file_name(fn, m.name), flags);
+                cb(m, f);
+                f.close();
+                ++cnt;
+            });
+        return cnt;
+    }
+
+    /// File name reported by files opened from members.
+    static std::string
+    member_file_name(std::string const & fn, std::string const & name)
+    {
+        return fn + ":" + name;
+    }
+    static bool
+    is_member_name(std::string const & name)
+    {
+        static std::string const sfx = ".fast5";
+        return name.size() > sfx.size() and name.compare(name.size() - sfx.size(), sfx.size(), sfx) == 0;
+    }
+
+private:
+    int _fd;
+    std::string _file_name;
+    std::vector< Member > _member_l;
+    std::unordered_map< std::string, size_t > _member_m;
+
+    static size_t block_size() { return 512; }
+    static std::uint64_t padded_size(std::uint64_t n)
+    {
+        return (n + block_size() - 1) / block_size() * block_size();
+    }
+
+    bool
+    pread_all(char * buf, size_t n, std::uint64_t offset) const
+    {
+        while (n > 0)
+        {
+            auto k = ::pread(_fd, buf, n, offset);
+            if (k <= 0) return false;
+            buf += k;
+            n -= k;
+            offset += k;
+        }
+        return true;
+    }
+
+    /// Parse a numeric header field: octal, or GNU base-256 if the high bit is set.
+    static std::uint64_t
+    parse_number(char const * p, size_t len)
+    {
+        std::uint64_t res = 0;
+        if (static_cast< unsigned char >(p[0]) & 0x80)
+        {
+            for (size_t i = 0; i < len; ++i)
+            {
+                res = (res << 8) | static_cast< unsigned char >(i == 0? p[i] & 0x7f : p[i]);
+            }
+            return res;
+        }
+        size_t i = 0;
+        while (i < len and p[i] == ' ') ++i;
+        for (; i < len and p[i] >= '0' and p[i] <= '7'; ++i)
+        {
+            res = (res << 3) | static_cast< std::uint64_t >(p[i] - '0');
+        }
+        return res;
+    }
+    static std::string
+    parse_string(char const * p, size_t len)
+    {
+        return std::string(p, strnlen(p, len));
+    }
+    /// Check the header checksum, computed with the checksum field as spaces.
+    static bool
+    valid_checksum(char const * b)
+    {
+        std::uint64_t sum = 0;
+        for (size_t i = 0; i < block_size(); ++i)
+        {
+            sum += (i >= 148 and i < 156)? ' ' : static_cast< unsigned char >(b[i]);
+        }
+        return sum == parse_number(b + 148, 8);
+    }
+    /// Apply the path and size records of a pax extended header.
+    static void
+    parse_pax(std::string const & data, std::string & name, std::uint64_t & size, bool & have_size)
+    {
+        size_t i = 0;
+        while (i < data.size())
+        {
+            // record: "<len> <key>=<value>\n", where len counts the whole record
+            auto sp = data.find(' ', i);
+            if (sp == std::string::npos) break;
+            auto len = std::stoull(data.substr(i, sp - i));
+            if (len == 0 or i + len > data.size()) break;
+            auto rec = data.substr(sp + 1, i + len - sp - 2);
+            auto eq = rec.find('=');
+            if (eq != std::string::npos)
+            {
+                auto key = rec.substr(0, eq);
+                if (key == "path") name = rec.substr(eq + 1);
+                else if (key == "size")
+                {
+                    size = std::stoull(rec.substr(eq + 1));
+                    have_size = true;
+                }
+            }
+            i += len;
+        }
+    }
+
+    /**
+     * Scan the entries of a tar archive.
+     * @param read_fcn Read the next bytes: read_fcn(char *, size_t), false on error.
+     * @param skip_fcn Skip the next bytes: skip_fcn(std::uint64_t).
+     * @param member_fcn Called for each member, when the archive is at its data; it must
+     * consume exactly the member size, e.g. with read_fcn or skip_fcn.
+     */
+    template < typename Read_Fcn, typename Skip_Fcn, typename Member_Fcn >
+    static void
+    scan(std::string const & fn, Read_Fcn && read_fcn, Skip_Fcn && skip_fcn, Member_Fcn && member_fcn)
+    {
+        std::uint64_t pos = 0;
+        char b[512];
+        // long name and pax overrides, for the next entry
+        std::string next_name;
+        std::uint64_t next_size = 0;
+        bool have_next_size = false;
+        while (true)
+        {
+            if (not read_fcn(b, block_size()))
+            {
+                // tolerate archives missing the end-of-archive blocks
+                if (pos > 0 and next_name.empty() and not have_next_size) return;
+                LOG_THROW
+                    << fn << ": truncated tar archive";
+            }
+            pos += block_size();
+            if (std::all_of(b, b + block_size(), [] (char c) { return c == 0; })) return;
+            if (not valid_checksum(b))
+            {
+                LOG_THROW
+                    << fn << ": not a valid tar archive: bad header at offset " << pos - block_size();
+            }
+            char type = b[156];
+            std::uint64_t size = have_next_size? next_size : parse_number(b + 124, 12);
+            if (type == 'L' or type == 'x')
+            {
+                // entry data describes the next entry
+                std::string data(size, '\0');
+                if (not read_fcn(&data[0], data.size()))
+                {
+                    LOG_THROW
+                        << fn << ": truncated tar archive";
+                }
+                skip_fcn(padded_size(size) - size);
+                pos += padded_size(size);
+                if (type == 'L')
+                {
+                    next_name = parse_string(data.data(), data.size());
+                }
+                else
+                {
+                    parse_pax(data, next_name, next_size, have_next_size);
+                }
+                continue;
+            }
+            std::string name = next_name;
+            if (name.empty())
+            {
+                name = parse_string(b, 100);
+                auto prefix = parse_string(b + 345, 155);
+                if (std::memcmp(b + 257, "ustar", 5) == 0 and not prefix.empty())
+                {
+                    name = prefix + "/" + name;
+                }
+            }
+            next_name.clear();
+            have_next_size = false;
+            if ((type == '0' or type == '\0' or type == '7') and is_member_name(name))
+            {
+                member_fcn(Member{ name, pos, size });
+                skip_fcn(padded_size(size) - size);
+            }
+            else
+            {
+                skip_fcn(padded_size(size));
+            }
+            pos += padded_size(size);
+        }
+    } // scan()
+}; // class Tar_Archive
+
+} // namespace fast5
+
+#endif
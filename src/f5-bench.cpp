@@ -0,0 +1,242 @@
+//
+// Part of: https://github.com/mateidavid/fast5
+//
+// Copyright (c) 2015-2017 Matei David, Ontario Institute for Cancer Research
+// MIT License
+//
+
+//
+// Benchmarks on a synthetic corpus: Huffman and bit packer coding, fast5 accessors on
+// unpacked and packed files, and File_Packer. Results are printed as tab-separated values.
+//
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "File_Generator.hpp"
+#include "File_Packer.hpp"
+
+using namespace std;
+
+namespace
+{
+
+size_t file_size(string const & fn)
+{
+    ifstream ifs(fn, ios::binary | ios::ate);
+    return ifs? (size_t)ifs.tellg() : 0;
+}
+
+/**
+ * Time a benchmark, and print one result line.
+ * @param name Benchmark name.
+ * @param variant Benchmark variant (e.g. unpacked/packed).
+ * @param num_iterations Number of runs of @p f.
+ * @param num_reads Number of reads processed by each run of @p f.
+ * @param f Benchmark body; each run processes all reads, and returns the number of bytes processed.
+ */
+void run_benchmark(string const & name, string const & variant, unsigned num_iterations,
+                   size_t num_reads, function< size_t() > f)
+{
+    typedef chrono::steady_clock clock_type;
+    size_t bytes = 0;
+    auto start = clock_type::now();
+    for (unsigned i = 0; i < num_iterations; ++i)
+    {
+        bytes += f();
+    }
+    double seconds = chrono::duration< double >(clock_type::now() - start).count();
+    size_t reads = num_iterations * num_reads;
+    cout
+        << name << "\t" << variant << "\t" << reads << "\t" << bytes << "\t"
+        << fixed << setprecision(6) << seconds << "\t"
+        << setprecision(2) << (double)bytes / (1 << 20) / seconds << "\t"
+        << reads / seconds << "\n";
+}
+
+template < typename T >
+size_t vector_bytes(vector< T > const & v)
+{
+    return v.size() * sizeof(T);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc > 5)
+    {
+        cerr << "use: " << argv[0] << " [<work_dir> [<num_files> [<num_samples> [<num_iterations>]]]]" << endl
+             << "Defaults: work_dir=. num_files=16 num_samples=40000 num_iterations=5" << endl;
+        return EXIT_FAILURE;
+    }
+    string work_dir = argc > 1? argv[1] : ".";
+    unsigned num_files = argc > 2? atoi(argv[2]) : 16;
+    size_t num_samples = argc > 3? atol(argv[3]) : 40000;
+    unsigned num_iterations = argc > 4? atoi(argv[4]) : 5;
+    vector< string > unpacked_fn_l;
+    vector< string > packed_fn_l;
+    vector< string > repacked_fn_l;
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        auto prefix = work_dir + "/f5-bench-" + to_string(i);
+        unpacked_fn_l.push_back(prefix + ".fast5");
+        packed_fn_l.push_back(prefix + ".pack.fast5");
+        repacked_fn_l.push_back(prefix + ".unpack.fast5");
+    }
+    try
+    {
+        // generate corpus
+        fast5::File_Generator gen;
+        gen.set_num_samples(num_samples);
+        for (unsigned i = 0; i < num_files; ++i)
+        {
+            gen.run(unpacked_fn_l[i], i);
+        }
+        cout << "benchmark\tvariant\treads\tbytes\tseconds\tmb_per_sec\treads_per_sec\n";
+        // File_Packer: bytes are input file sizes
+        auto run_packer = [&] (fast5::File_Packer const & fp,
+                               vector< string > const & ifn_l, vector< string > const & ofn_l) {
+            size_t bytes = 0;
+            for (unsigned i = 0; i < num_files; ++i)
+            {
+                fp.run(ifn_l[i], ofn_l[i]);
+                bytes += file_size(ifn_l[i]);
+            }
+            return bytes;
+        };
+        fast5::File_Packer packer(1);
+        packer.set_force(true);
+        fast5::File_Packer unpacker(2);
+        unpacker.set_force(true);
+        run_benchmark("file_packer_run", "pack", num_iterations, num_files,
+                      [&] () { return run_packer(packer, unpacked_fn_l, packed_fn_l); });
+        run_benchmark("file_packer_run", "unpack", num_iterations, num_files,
+                      [&] () { return run_packer(unpacker, packed_fn_l, repacked_fn_l); });
+        packer.set_check(false);
+        run_benchmark("file_packer_run", "pack_no_check", num_iterations, num_files,
+                      [&] () { return run_packer(packer, unpacked_fn_l, packed_fn_l); });
+        // coders: one vector of raw samples per read; bytes are decoded sizes
+        {
+            vector< vector< fast5::Raw_Int_Sample > > rsi_l;
+            for (auto const & fn : unpacked_fn_l)
+            {
+                fast5::File f(fn);
+                rsi_l.push_back(f.get_raw_int_samples());
+            }
+            auto const & huffman = fast5::Huffman_Packer::get_coder("fast5_rw_1");
+            auto const & bit_packer = fast5::Bit_Packer::get_packer();
+            vector< pair< fast5::Huffman_Packer::Code_Type, fast5::Huffman_Packer::Code_Params_Type > > huffman_code_l;
+            vector< pair< fast5::Bit_Packer::Code_Type, fast5::Bit_Packer::Code_Params_Type > > bit_code_l;
+            run_benchmark("huffman_encode", "rw", num_iterations, num_files, [&] () {
+                    size_t bytes = 0;
+                    huffman_code_l.clear();
+                    for (auto const & rsi : rsi_l)
+                    {
+                        huffman_code_l.push_back(huffman.encode(rsi, true));
+                        bytes += vector_bytes(rsi);
+                    }
+                    return bytes;
+                });
+            run_benchmark("huffman_decode", "rw", num_iterations, num_files, [&] () {
+                    size_t bytes = 0;
+                    for (auto const & p : huffman_code_l)
+                    {
+                        bytes += vector_bytes(huffman.decode< fast5::Raw_Int_Sample >(p.first, p.second));
+                    }
+                    return bytes;
+                });
+            run_benchmark("bit_packer_encode", "rw", num_iterations, num_files, [&] () {
+                    size_t bytes = 0;
+                    bit_code_l.clear();
+                    for (auto const & rsi : rsi_l)
+                    {
+                        bit_code_l.push_back(bit_packer.encode(rsi, 12));
+                        bytes += vector_bytes(rsi);
+                    }
+                    return bytes;
+                });
+            run_benchmark("bit_packer_decode", "rw", num_iterations, num_files, [&] () {
+                    size_t bytes = 0;
+                    for (auto const & p : bit_code_l)
+                    {
+                        bytes += vector_bytes(bit_packer.decode< fast5::Raw_Int_Sample >(p.first, p.second));
+                    }
+                    return bytes;
+                });
+        }
+        // accessors: files are opened outside of the timed section; bytes are decoded sizes
+        for (auto const & variant : { string("unpacked"), string("packed") })
+        {
+            auto const & fn_l = variant == "unpacked"? unpacked_fn_l : packed_fn_l;
+            vector< unique_ptr< fast5::File > > f_l;
+            for (auto const & fn : fn_l)
+            {
+                f_l.emplace_back(new fast5::File(fn));
+            }
+            auto run_accessor = [&] (string const & name, function< size_t(fast5::File const &) > g) {
+                run_benchmark(name, variant, num_iterations, num_files, [&] () {
+                        size_t bytes = 0;
+                        for (auto const & f_ptr : f_l)
+                        {
+                            bytes += g(*f_ptr);
+                        }
+                        return bytes;
+                    });
+            };
+            run_accessor("get_channel_id_params", [] (fast5::File const & f) {
+                    f.get_channel_id_params();
+                    return sizeof(fast5::Channel_Id_Params);
+                });
+            run_accessor("get_raw_samples_params", [] (fast5::File const & f) {
+                    f.get_raw_samples_params();
+                    return sizeof(fast5::Raw_Samples_Params);
+                });
+            run_accessor("get_raw_samples", [] (fast5::File const & f) {
+                    return vector_bytes(f.get_raw_samples());
+                });
+            run_accessor("get_eventdetection_events", [] (fast5::File const & f) {
+                    return vector_bytes(f.get_eventdetection_events());
+                });
+            run_accessor("get_basecall_fastq", [] (fast5::File const & f) {
+                    size_t bytes = 0;
+                    for (unsigned st = 0; st < 3; ++st)
+                    {
+                        bytes += f.get_basecall_fastq(st).size();
+                    }
+                    return bytes;
+                });
+            run_accessor("get_basecall_events", [] (fast5::File const & f) {
+                    size_t bytes = 0;
+                    for (unsigned st = 0; st < 2; ++st)
+                    {
+                        bytes += vector_bytes(f.get_basecall_events(st));
+                    }
+                    return bytes;
+                });
+            run_accessor("get_basecall_alignment", [] (fast5::File const & f) {
+                    return vector_bytes(f.get_basecall_alignment());
+                });
+        }
+    }
+    catch (hdf5_tools::Exception & e)
+    {
+        cerr << "hdf5 error: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+    for (unsigned i = 0; i < num_files; ++i)
+    {
+        remove(unpacked_fn_l[i].c_str());
+        remove(packed_fn_l[i].c_str());
+        remove(repacked_fn_l[i].c_str());
+    }
+    assert(fast5::File::get_object_count() == 0);
+}
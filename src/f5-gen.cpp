@@ -0,0 +1,43 @@
+//
+// Part of: https://github.com/mateidavid/fast5
+//
+// Copyright (c) 2015-2017 Matei David, Ontario Institute for Cancer Research
+// MIT License
+//
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "File_Generator.hpp"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3 or argc > 5)
+    {
+        cerr << "use: " << argv[0] << " <output_prefix> <num_files> [<num_samples> [<seed>]]" << endl
+             << "Write synthetic fast5 files <output_prefix><i>.fast5, for i in [0, num_files)." << endl;
+        return EXIT_FAILURE;
+    }
+    string prefix(argv[1]);
+    unsigned num_files = atoi(argv[2]);
+    fast5::File_Generator gen;
+    if (argc > 3) gen.set_num_samples(atol(argv[3]));
+    if (argc > 4) gen.set_seed(atoi(argv[4]));
+    try
+    {
+        for (unsigned i = 0; i < num_files; ++i)
+        {
+            gen.run(prefix + to_string(i) + ".fast5", i);
+        }
+    }
+    catch (hdf5_tools::Exception & e)
+    {
+        cerr << "hdf5 error: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+    assert(fast5::File::get_object_count() == 0);
+}
@@ -0,0 +1,139 @@
+//
+// Part of: https://github.com/mateidavid/fast5
+//
+// Copyright (c) 2015-2017 Matei David, Ontario Institute for Cancer Research
+// MIT License
+//
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <tclap/CmdLine.h>
+#include "logger.hpp"
+
+#include "fast5.hpp"
+#include "Read_Index.hpp"
+
+using namespace std;
+
+namespace opts
+{
+    using namespace TCLAP;
+    string description = "Build and query an index of the reads in many fast5 files.";
+    CmdLine cmd_parser(description);
+    //
+    MultiArg< string > log_level("", "log", "Log level. (default: info)", false, "string", cmd_parser);
+    MultiSwitchArg extra_verbosity("v", "", "Increase verbosity", cmd_parser);
+    //
+    ValueArg< string > build("b", "build", "Build index from the input directories and fast5 files, and write it to this file.", false, "", "file", cmd_parser);
+    ValueArg< unsigned > num_threads("j", "threads", "Number of files to scan in parallel. (default: 1)", false, 1, "int", cmd_parser);
+    SwitchArg recurse("R", "recurse", "Recurse in input directories.", cmd_parser);
+    //
+    ValueArg< string > index("i", "index", "Look up the input read ids (default: stdin) in this index.", false, "", "file", cmd_parser);
+    SwitchArg list("l", "list", "With --index: list all reads in the index.", cmd_parser);
+    SwitchArg raw("", "raw", "With --index: open each read, and print its raw samples.", cmd_parser);
+    //
+    UnlabeledMultiArg< string > inputs("inputs", "With --build: input directories and fast5 files. With --index: read ids.", false, "path", cmd_parser);
+} // opts
+
+void print_entry(fast5::Read_Index::Entry const & e)
+{
+    cout
+        << e.read_id << "\t" << e.file_name << "\t" << e.path << "\t" << e.packed << "\t"
+        << e.num_samples << "\t" << e.channel_number << "\t" << e.start_time << "\n";
+}
+
+void print_raw_samples(fast5::Read_Index const & idx, string const & read_id)
+{
+    fast5::Read_Index::Open_Read r;
+    idx.open_read(read_id, r, fast5::File::open_raw_only);
+    auto rsi = r.file().get_raw_int_samples(r.read_name());
+    cout << read_id << "\t";
+    for (size_t i = 0; i < rsi.size(); ++i)
+    {
+        cout << (i > 0? "," : "") << rsi[i];
+    }
+    cout << "\n";
+}
+
+int main(int argc, char * argv[])
+{
+    opts::cmd_parser.parse(argc, argv);
+    // set log levels
+    auto default_level = (int)logger::level::info + opts::extra_verbosity.getValue();
+    logger::Logger::set_default_level(default_level);
+    logger::Logger::set_levels_from_options(opts::log_level, &clog);
+    // print options
+    LOG(info) << "program: " << opts::cmd_parser.getProgramName() << endl;
+    LOG(info) << "version: " << opts::cmd_parser.getVersion() << endl;
+    LOG(info) << "args: " << opts::cmd_parser.getOrigArgv() << endl;
+    if (opts::build.isSet() + opts::index.isSet() != 1)
+    {
+        LOG_EXIT << "exactly one of --build/--index must be given" << endl;
+    }
+    try
+    {
+        fast5::Read_Index idx;
+        if (opts::build.isSet())
+        {
+            auto fn_l = fast5::Read_Index::find_files(opts::inputs, opts::recurse);
+            unsigned num_threads = opts::num_threads > 0? opts::num_threads : thread::hardware_concurrency();
+            LOG(info) << "files: " << fn_l.size() << endl;
+            LOG(info) << "threads: " << num_threads << endl;
+            auto err_l = idx.build(fn_l, num_threads);
+            for (auto const & e : err_l)
+            {
+                LOG(error) << "error indexing " << fn_l[e.first] << ": " << e.second << endl;
+            }
+            idx.save(opts::build);
+            LOG(info) << "reads: " << idx.size() << endl;
+            return err_l.empty()? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        idx.load(opts::index);
+        if (opts::list)
+        {
+            for (size_t i = 0; i < idx.size(); ++i)
+            {
+                print_entry(idx.get_entry(i));
+            }
+            return EXIT_SUCCESS;
+        }
+        vector< string > read_id_l = opts::inputs;
+        if (read_id_l.empty())
+        {
+            string read_id;
+            while (cin >> read_id) read_id_l.push_back(read_id);
+        }
+        size_t missing = 0;
+        for (auto const & read_id : read_id_l)
+        {
+            fast5::Read_Index::Entry e;
+            if (not idx.find(read_id, e))
+            {
+                LOG(warning) << "read not found: " << read_id << endl;
+                ++missing;
+            }
+            else if (opts::raw)
+            {
+                print_raw_samples(idx, read_id);
+            }
+            else
+            {
+                print_entry(e);
+            }
+        }
+        if (missing > 0) return EXIT_FAILURE;
+    }
+    catch (hdf5_tools::Exception & e)
+    {
+        LOG_EXIT << "hdf5 error: " << e.what() << endl;
+    }
+    catch (exception & e)
+    {
+        LOG_EXIT << e.what() << endl;
+    }
+    assert(fast5::File::get_object_count() == 0);
+}
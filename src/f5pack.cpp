@@ -5,10 +5,18 @@
 // MIT License
 //
 
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
 
 #include <tclap/CmdLine.h>
 #include "logger.hpp"
@@ -21,11 +29,12 @@ using namespace std;
 namespace opts
 {
     using namespace TCLAP;
-    string description = "Pack an ONT fast5 file.";
+    string description = "Pack ONT fast5 files.";
     CmdLine cmd_parser(description);
     //
     MultiArg< string > log_level("", "log", "Log level. (default: info)", false, "string", cmd_parser);
     MultiSwitchArg extra_verbosity("v", "", "Increase verbosity", cmd_parser);
+    SwitchArg log_async("", "log-async", "Write log messages from a background thread.", cmd_parser);
     //
     SwitchArg al_drop("", "al-drop", "Drop basecall alignment data.", cmd_parser);
     SwitchArg al_copy("", "al-copy", "Copy basecall alignment data.", cmd_parser);
@@ -55,17 +64,152 @@ namespace opts
     ValueArg< unsigned > p_model_state_bits("", "p-model-state-bits", "P_Model_State bits to keep.", false, fast5::File_Packer::default_p_model_state_bits(), "int", cmd_parser);
     ValueArg< unsigned > qv_bits("", "qv-bits", "QV bits to keep.", false, fast5::File_Packer::max_qv_bits(), "int", cmd_parser);
     SwitchArg no_check("n", "no-check", "Don't check packing.", cmd_parser);
+    SwitchArg check_from_disk("", "check-from-disk", "Check packing by reading back the output file, rather than decoding packed data in memory.", cmd_parser);
+    SwitchArg check_async("", "check-async", "Decode packed data for checking on a separate thread, while it is being written.", cmd_parser);
     SwitchArg force("f", "force", "Overwrite output file if it exists.", cmd_parser);
+    SwitchArg in_memory("m", "in-memory", "Build output file in memory, write it out on close.", cmd_parser);
+    ValueArg< unsigned > num_threads("j", "threads", "Number of files to process in parallel. (default: 1)", false, 1, "int", cmd_parser);
+    SwitchArg recurse("R", "recurse", "Recurse in input directories.", cmd_parser);
+    SwitchArg pipeline("", "pipeline", "Use a staged read/pack/write pipeline, with files held in memory between stages.", cmd_parser);
+    ValueArg< unsigned > queue_size("", "queue-size", "Files queued between pipeline stages. (default: 2 * threads)", false, 0, "int", cmd_parser);
+    ValueArg< string > output_dir("o", "output", "Output directory. If not given, the inputs must be one input and one output file.", false, "", "dir", cmd_parser);
+    ValueArg< string > multi_read("", "multi-read", "Write all inputs as reads of one multi-read output file. Use the copy options to convert files without packing them.", false, "", "file", cmd_parser);
+    ValueArg< string > pack_archive("", "pack-archive", "Add the raw samples and fastq of all inputs, packed, to this pack archive.", false, "", "file", cmd_parser);
+    SwitchArg append_archive("", "append-archive", "With --pack-archive: add reads to an existing archive.", cmd_parser);
+    ValueArg< string > unpack_archive("", "unpack-archive", "Write the reads of this pack archive to one multi-read output file, given as the only input.", false, "", "file", cmd_parser);
     //
     SwitchArg fastq("", "fastq", "Pack fastq data, drop rest.", cmd_parser);
     SwitchArg archive("", "archive", "Pack raw saples data, drop rest.", cmd_parser);
     SwitchArg unpack("u", "unpack", "Unpack files.", cmd_parser);
     SwitchArg pack("p", "pack", "Pack files (default, if no other pack/unpack/copy options).", cmd_parser);
     //
-    UnlabeledValueArg< string > input_fn("input", "Input fast5 file.", true, "", "file", cmd_parser);
-    UnlabeledValueArg< string > output_fn("output", "Output fast5 file.", true, "", "file", cmd_parser);
+    UnlabeledMultiArg< string > inputs("inputs", "With --output or --multi-read: input directories, fast5 files, or files of fast5 file names (default: stdin). For input directories, the subdirectory hierarchy (if traversed with --recurse) is recreated in the output directory. Without --output: input and output fast5 files.", false, "path", cmd_parser);
 } // opts
 
+// list of (input file, output file) pairs
+typedef vector< pair< string, string > > File_List;
+
+bool is_dir(string const & p)
+{
+    struct stat st;
+    return stat(p.c_str(), &st) == 0 and S_ISDIR(st.st_mode);
+}
+
+string join_path(string const & dn, string const & fn)
+{
+    return dn.empty()? fn : fn.empty()? dn : dn + "/" + fn;
+}
+
+string base_name(string const & p)
+{
+    auto pos = p.find_last_of('/');
+    return pos == string::npos? p : p.substr(pos + 1);
+}
+
+void make_dirs(string const & dn)
+{
+    for (size_t pos = 0; pos != string::npos; )
+    {
+        pos = dn.find('/', pos + 1);
+        auto prefix = dn.substr(0, pos);
+        if (mkdir(prefix.c_str(), 0777) != 0 and errno != EEXIST)
+        {
+            LOG_EXIT << "error creating directory: " << prefix << endl;
+        }
+    }
+}
+
+void add_fast5(File_List & l, string const & fn, string const & rel_dn)
+{
+    LOG(info) << "adding fast5 fn=" << fn << " rel_dn=" << rel_dn << endl;
+    l.emplace_back(fn, join_path(join_path(opts::output_dir, rel_dn), base_name(fn)));
+}
+
+void add_dir(File_List & l, string const & dn, string const & rel_dn)
+{
+    LOG(info) << "processing dir dn=" << dn << endl;
+    DIR * dir_ptr = opendir(dn.c_str());
+    if (not dir_ptr)
+    {
+        LOG(warning) << "error opening directory: " << dn << endl;
+        return;
+    }
+    vector< string > name_l;
+    while (auto ent_ptr = readdir(dir_ptr))
+    {
+        string name = ent_ptr->d_name;
+        if (name != "." and name != "..") name_l.push_back(name);
+    }
+    closedir(dir_ptr);
+    sort(name_l.begin(), name_l.end());
+    vector< string > subdir_l;
+    for (auto const & name : name_l)
+    {
+        auto fn = join_path(dn, name);
+        if (is_dir(fn))
+        {
+            subdir_l.push_back(name);
+        }
+        else if (fast5::File::is_valid_file(fn))
+        {
+            add_fast5(l, fn, rel_dn);
+        }
+    }
+    if (not opts::recurse) return;
+    for (auto const & name : subdir_l)
+    {
+        add_dir(l, join_path(dn, name), join_path(rel_dn, name));
+    }
+}
+
+void add_fofn(File_List & l, string const & fn)
+{
+    LOG(info) << "processing fofn fn=" << fn << endl;
+    ifstream ifs;
+    if (fn != "-")
+    {
+        ifs.open(fn);
+        if (not ifs) LOG_EXIT << "error opening fofn: " << fn << endl;
+    }
+    istream & is = (fn != "-"? ifs : cin);
+    string p;
+    while (getline(is, p))
+    {
+        p.erase(0, p.find_first_not_of(" \t\r"));
+        p.erase(p.find_last_not_of(" \t\r") + 1);
+        if (fast5::File::is_valid_file(p))
+        {
+            add_fast5(l, p, "");
+        }
+        else
+        {
+            LOG(warning) << "fofn line not a fast5 file: " << p << endl;
+        }
+    }
+}
+
+File_List add_paths(vector< string > pl)
+{
+    File_List l;
+    if (pl.empty()) pl.push_back("-");
+    for (auto const & p : pl)
+    {
+        if (is_dir(p))
+        {
+            add_dir(l, p, "");
+        }
+        else if (fast5::File::is_valid_file(p))
+        {
+            add_fast5(l, p, "");
+        }
+        else
+        {
+            add_fofn(l, p);
+        }
+    }
+    return l;
+}
+
 
 int main(int argc, char * argv[])
 {
@@ -74,6 +218,7 @@ int main(int argc, char * argv[])
     auto default_level = (int)logger::level::info + opts::extra_verbosity.getValue();
     logger::Logger::set_default_level(default_level);
     logger::Logger::set_levels_from_options(opts::log_level, &clog);
+    if (opts::log_async) logger::Logger::set_async(true);
     // print options
     LOG(info) << "program: " << opts::cmd_parser.getProgramName() << endl;
     LOG(info) << "version: " << opts::cmd_parser.getVersion() << endl;
@@ -147,7 +292,7 @@ int main(int argc, char * argv[])
     LOG(info) << "fq: " << (opts::fq_pack? "pack" : opts::fq_unpack? "unpack" : opts::fq_copy? "copy" : "drop") << endl;
     LOG(info) << "ev: " << (opts::ev_pack? "pack" : opts::ev_unpack? "unpack" : opts::ev_copy? "copy" : "drop") << endl;
     LOG(info) << "al: " << (opts::al_pack? "pack" : opts::al_unpack? "unpack" : opts::al_copy? "copy" : "drop") << endl;
-    LOG(info) << "check: " << (not opts::no_check? "yes" : "no") << endl;
+    LOG(info) << "check: " << (not opts::no_check? (opts::check_from_disk? "from disk" : "in memory") : "no") << endl;
     // set File_Packer options
     int rw_policy = (opts::rw_pack? 1 : opts::rw_unpack? 2 : opts::rw_copy? 3 : 0);
     int ed_policy = (opts::ed_pack? 1 : opts::ed_unpack? 2 : opts::ed_copy? 3 : 0);
@@ -156,10 +301,89 @@ int main(int argc, char * argv[])
     int al_policy = (opts::al_pack? 1 : opts::al_unpack? 2 : opts::al_copy? 3 : 0);
     fast5::File_Packer fp(rw_policy, ed_policy, fq_policy, ev_policy, al_policy);
     fp.set_check(not opts::no_check);
+    fp.set_check_from_disk(opts::check_from_disk);
+    fp.set_check_async(opts::check_async);
     fp.set_force(opts::force);
+    fp.set_in_memory(opts::in_memory);
     fp.set_qv_bits(opts::qv_bits);
     fp.set_p_model_state_bits(opts::p_model_state_bits);
-    fp.run(opts::input_fn, opts::output_fn);
+    size_t processed_files = 1;
+    size_t errored_files = 0;
+    if (opts::output_dir.isSet() + opts::multi_read.isSet() + opts::pack_archive.isSet() + opts::unpack_archive.isSet() > 1)
+    {
+        LOG_EXIT << "at most one of --output/--multi-read/--pack-archive/--unpack-archive may be given" << endl;
+    }
+    if (opts::pack_archive.isSet())
+    {
+        auto fl = add_paths(opts::inputs);
+        vector< string > ifn_l;
+        for (auto const & p : fl)
+        {
+            ifn_l.push_back(p.first);
+        }
+        LOG(info) << "files: " << ifn_l.size() << endl;
+        auto err_l = fp.run_to_pack_archive(ifn_l, opts::pack_archive, opts::append_archive);
+        for (auto const & e : err_l)
+        {
+            LOG(error) << "error archiving " << ifn_l[e.first] << ": " << e.second << endl;
+        }
+        processed_files = ifn_l.size();
+        errored_files = err_l.size();
+    }
+    else if (opts::unpack_archive.isSet())
+    {
+        if (opts::inputs.get().size() != 1)
+        {
+            LOG_EXIT << "with --unpack-archive, exactly one output file must be given" << endl;
+        }
+        fp.run_from_pack_archive(opts::unpack_archive, opts::inputs.get()[0]);
+    }
+    else if (opts::multi_read.isSet())
+    {
+        auto fl = add_paths(opts::inputs);
+        vector< string > ifn_l;
+        for (auto const & p : fl)
+        {
+            ifn_l.push_back(p.first);
+        }
+        LOG(info) << "files: " << ifn_l.size() << endl;
+        auto err_l = fp.run_multi_read(ifn_l, opts::multi_read);
+        for (auto const & e : err_l)
+        {
+            LOG(error) << "error adding " << ifn_l[e.first] << ": " << e.second << endl;
+        }
+        processed_files = ifn_l.size();
+        errored_files = err_l.size();
+    }
+    else if (not opts::output_dir.isSet())
+    {
+        if (opts::inputs.get().size() != 2)
+        {
+            LOG_EXIT << "without --output, exactly one input and one output file must be given" << endl;
+        }
+        fp.run(opts::inputs.get()[0], opts::inputs.get()[1]);
+    }
+    else
+    {
+        auto fl = add_paths(opts::inputs);
+        for (auto const & p : fl)
+        {
+            auto pos = p.second.find_last_of('/');
+            if (pos != string::npos and pos > 0) make_dirs(p.second.substr(0, pos));
+        }
+        unsigned num_threads = opts::num_threads > 0? opts::num_threads : thread::hardware_concurrency();
+        LOG(info) << "files: " << fl.size() << endl;
+        LOG(info) << "threads: " << num_threads << endl;
+        auto err_l = (not opts::pipeline
+                      ? fp.run_batch(fl, num_threads)
+                      : fp.run_pipeline(fl, num_threads, opts::queue_size));
+        for (auto const & e : err_l)
+        {
+            LOG(error) << "error packing " << fl[e.first].first << ": " << e.second << endl;
+        }
+        processed_files = fl.size();
+        errored_files = err_l.size();
+    }
     auto cnt = fp.get_counts();
     cout
         << std::fixed << std::setprecision(2)
@@ -181,5 +405,53 @@ int main(int argc, char * argv[])
         << "al_count\t" << cnt.al_count << "\n"
         << "al_template_step_bits\t" << (double)cnt.al_template_step_bits/cnt.al_count << "\n"
         << "al_complement_step_bits\t" << (double)cnt.al_complement_step_bits/cnt.al_count << "\n"
-        << "al_move_bits\t" << (double)cnt.al_move_bits/cnt.al_count << "\n";
+        << "al_move_bits\t" << (double)cnt.al_move_bits/cnt.al_count << "\n"
+        << "processed_files\t" << processed_files << "\n";
+    auto print_type = [] (string const & name,
+                          double read_time, double encode_time, double check_time, double write_time,
+                          size_t read_bytes, size_t write_bytes) {
+        if (read_bytes == 0 and write_bytes == 0) return;
+        cout
+            << name << "_read_time\t" << read_time << "\n"
+            << name << "_encode_time\t" << encode_time << "\n"
+            << name << "_check_time\t" << check_time << "\n"
+            << name << "_write_time\t" << write_time << "\n"
+            << name << "_read_bytes\t" << read_bytes << "\n"
+            << name << "_write_bytes\t" << write_bytes << "\n";
+    };
+    print_type("rs", cnt.rs_read_time, cnt.rs_encode_time, cnt.rs_check_time, cnt.rs_write_time,
+               cnt.rs_read_bytes, cnt.rs_write_bytes);
+    print_type("ed", cnt.ed_read_time, cnt.ed_encode_time, cnt.ed_check_time, cnt.ed_write_time,
+               cnt.ed_read_bytes, cnt.ed_write_bytes);
+    print_type("fq", cnt.fq_read_time, cnt.fq_encode_time, cnt.fq_check_time, cnt.fq_write_time,
+               cnt.fq_read_bytes, cnt.fq_write_bytes);
+    print_type("ev", cnt.ev_read_time, cnt.ev_encode_time, cnt.ev_check_time, cnt.ev_write_time,
+               cnt.ev_read_bytes, cnt.ev_write_bytes);
+    print_type("al", cnt.al_read_time, cnt.al_encode_time, cnt.al_check_time, cnt.al_write_time,
+               cnt.al_read_bytes, cnt.al_write_bytes);
+    cout
+        << "open_time\t" << cnt.open_time << "\n"
+        << "close_time\t" << cnt.close_time << "\n"
+        << "hdf5_read_bytes\t" << cnt.hdf5_read_bytes << "\n"
+        << "hdf5_write_bytes\t" << cnt.hdf5_write_bytes << "\n";
+    if (errored_files > 0)
+    {
+        cout << "errored_files\t" << errored_files << "\n";
+    }
+    if (opts::pipeline)
+    {
+        auto const & pl_cnt = fp.get_pipeline_counts();
+        auto print_stage = [] (string const & name, fast5::File_Packer::Stage_Counts const & st_cnt) {
+            cout
+                << name << "_files\t" << st_cnt.files << "\n"
+                << name << "_bytes\t" << st_cnt.bytes << "\n"
+                << name << "_busy_time\t" << st_cnt.busy_time << "\n"
+                << name << "_mb_per_sec\t" << (double)st_cnt.bytes / (1 << 20) / st_cnt.busy_time << "\n";
+        };
+        print_stage("read", pl_cnt.read);
+        print_stage("transform", pl_cnt.transform);
+        print_stage("write", pl_cnt.write);
+        cout << "pipeline_total_time\t" << pl_cnt.total_time << "\n";
+    }
+    return errored_files > 0;
 }
@@ -18,9 +18,12 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <atomic>
 #include <set>
 #include <map>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "logger.hpp"
 #include "fast5_version.hpp"
@@ -58,11 +61,12 @@ struct Channel_Id_Params
           sampling_rate(0.0) {}
     void read(hdf5_tools::File const & f, std::string const & p)
     {
-        f.read(p + "/channel_number", channel_number);
-        f.read(p + "/digitisation", digitisation);
-        f.read(p + "/offset", offset);
-        f.read(p + "/range", range);
-        f.read(p + "/sampling_rate", sampling_rate);
+        f.read_attributes(p, {
+                { "channel_number", channel_number },
+                { "digitisation", digitisation },
+                { "offset", offset },
+                { "range", range },
+                { "sampling_rate", sampling_rate } });
     }
     void write(hdf5_tools::File const & f, std::string const & p) const
     {
@@ -98,11 +102,12 @@ struct Raw_Samples_Params
     }
     void read(hdf5_tools::File const & f, std::string const & p)
     {
-        f.read(p + "/read_id", read_id);
-        f.read(p + "/read_number", read_number);
-        f.read(p + "/start_mux", start_mux);
-        f.read(p + "/start_time", start_time);
-        f.read(p + "/duration", duration);
+        f.read_attributes(p, {
+                { "read_id", read_id },
+                { "read_number", read_number },
+                { "start_mux", start_mux },
+                { "start_time", start_time },
+                { "duration", duration } });
     }
     void write(hdf5_tools::File const & f, std::string const & p) const
     {
@@ -153,30 +158,28 @@ struct EventDetection_Event
     }
     static hdf5_tools::Compound_Map const & compound_map()
     {
-        static hdf5_tools::Compound_Map m;
-        static bool inited = false;
-        if (not inited)
-        {
-            m.add_member("mean", &EventDetection_Event::mean);
-            m.add_member("start", &EventDetection_Event::start);
-            m.add_member("length", &EventDetection_Event::length);
-            m.add_member("stdv", &EventDetection_Event::stdv);
-            inited = true;
-        }
+        static hdf5_tools::Compound_Map const m = [] ()
+            {
+                hdf5_tools::Compound_Map res;
+                res.add_member("mean", &EventDetection_Event::mean);
+                res.add_member("start", &EventDetection_Event::start);
+                res.add_member("length", &EventDetection_Event::length);
+                res.add_member("stdv", &EventDetection_Event::stdv);
+                return res;
+            }();
         return m;
     }
     static hdf5_tools::Compound_Map const & alt_compound_map()
     {
-        static hdf5_tools::Compound_Map m;
-        static bool inited = false;
-        if (not inited)
-        {
-            m.add_member("mean", &EventDetection_Event::mean);
-            m.add_member("start", &EventDetection_Event::start);
-            m.add_member("length", &EventDetection_Event::length);
-            m.add_member("variance", &EventDetection_Event::stdv);
-            inited = true;
-        }
+        static hdf5_tools::Compound_Map const m = [] ()
+            {
+                hdf5_tools::Compound_Map res;
+                res.add_member("mean", &EventDetection_Event::mean);
+                res.add_member("start", &EventDetection_Event::start);
+                res.add_member("length", &EventDetection_Event::length);
+                res.add_member("variance", &EventDetection_Event::stdv);
+                return res;
+            }();
         return m;
     }
 }; // struct EventDetection_Event
@@ -205,34 +208,19 @@ struct EventDetection_Events_Params
     }
     void read(hdf5_tools::File const & f, std::string const & p)
     {
-        auto a_v = f.get_attr_list(p);
-        std::set< std::string > a_s(a_v.begin(), a_v.end());
-        f.read(p + "/read_number", read_number);
-        f.read(p + "/scaling_used", scaling_used);
-        f.read(p + "/start_mux", start_mux);
-        f.read(p + "/start_time", start_time);
-        f.read(p + "/duration", duration);
-        // optional fields
-        if (a_s.count("read_id"))
-        {
-            f.read(p + "/read_id", read_id);
-        }
-        if (a_s.count("median_before"))
-        {
-            f.read(p + "/median_before", median_before);
-        }
-        else
-        {
-            median_before = std::nan("");
-        }
-        if (a_s.count("abasic_found"))
-        {
-            f.read(p + "/abasic_found", abasic_found);
-        }
-        else
-        {
-            abasic_found = 2;
-        }
+        // defaults for optional fields
+        median_before = std::nan("");
+        abasic_found = 2;
+        f.read_attributes(p, {
+                { "read_number", read_number },
+                { "scaling_used", scaling_used },
+                { "start_mux", start_mux },
+                { "start_time", start_time },
+                { "duration", duration },
+                // optional fields
+                { "read_id", read_id, false },
+                { "median_before", median_before, false },
+                { "abasic_found", abasic_found, false } });
     }
     void write(hdf5_tools::File const & f, std::string const & p) const
     {
@@ -301,17 +289,16 @@ struct Basecall_Model_State
     }
     static hdf5_tools::Compound_Map const & compound_map()
     {
-        static hdf5_tools::Compound_Map m;
-        static bool inited = false;
-        if (not inited)
-        {
-            m.add_member("level_mean", &Basecall_Model_State::level_mean);
-            m.add_member("level_stdv", &Basecall_Model_State::level_stdv);
-            m.add_member("sd_mean", &Basecall_Model_State::sd_mean);
-            m.add_member("sd_stdv", &Basecall_Model_State::sd_stdv);
-            m.add_member("kmer", &Basecall_Model_State::kmer);
-            inited = true;
-        }
+        static hdf5_tools::Compound_Map const m = [] ()
+            {
+                hdf5_tools::Compound_Map res;
+                res.add_member("level_mean", &Basecall_Model_State::level_mean);
+                res.add_member("level_stdv", &Basecall_Model_State::level_stdv);
+                res.add_member("sd_mean", &Basecall_Model_State::sd_mean);
+                res.add_member("sd_stdv", &Basecall_Model_State::sd_stdv);
+                res.add_member("kmer", &Basecall_Model_State::kmer);
+                return res;
+            }();
         return m;
     }
 }; // struct Basecall_Model_State
@@ -330,12 +317,13 @@ struct Basecall_Model_Params
     double var_sd;
     void read(hdf5_tools::File const & f, std::string const & p)
     {
-        f.read(p + "/scale", scale);
-        f.read(p + "/shift", shift);
-        f.read(p + "/drift", drift);
-        f.read(p + "/var", var);
-        f.read(p + "/scale_sd", scale_sd);
-        f.read(p + "/var_sd", var_sd);
+        f.read_attributes(p, {
+                { "scale", scale },
+                { "shift", shift },
+                { "drift", drift },
+                { "var", var },
+                { "scale_sd", scale_sd },
+                { "var_sd", var_sd } });
     }
     void write(hdf5_tools::File const & f, std::string const & p) const
     {
@@ -363,8 +351,9 @@ struct Basecall_Fastq_Pack
         bp_params = f.get_attr_map(p + "/BP");
         f.read(p + "/QV", qv);
         qv_params = f.get_attr_map(p + "/QV");
-        f.read(p + "/read_name", read_name);
-        f.read(p + "/qv_bits", qv_bits);
+        f.read_attributes(p, {
+                { "read_name", read_name },
+                { "qv_bits", qv_bits } });
     }
     void write(hdf5_tools::File const & f, std::string const & p) const
     {
@@ -404,19 +393,18 @@ struct Basecall_Event
     }
     static hdf5_tools::Compound_Map const & compound_map()
     {
-        static hdf5_tools::Compound_Map m;
-        static bool inited = false;
-        if (not inited)
-        {
-            m.add_member("mean", &Basecall_Event::mean);
-            m.add_member("stdv", &Basecall_Event::stdv);
-            m.add_member("start", &Basecall_Event::start);
-            m.add_member("length", &Basecall_Event::length);
-            m.add_member("p_model_state", &Basecall_Event::p_model_state);
-            m.add_member("move", &Basecall_Event::move);
-            m.add_member("model_state", &Basecall_Event::model_state);
-            inited = true;
-        }
+        static hdf5_tools::Compound_Map const m = [] ()
+            {
+                hdf5_tools::Compound_Map res;
+                res.add_member("mean", &Basecall_Event::mean);
+                res.add_member("stdv", &Basecall_Event::stdv);
+                res.add_member("start", &Basecall_Event::start);
+                res.add_member("length", &Basecall_Event::length);
+                res.add_member("p_model_state", &Basecall_Event::p_model_state);
+                res.add_member("move", &Basecall_Event::move);
+                res.add_member("model_state", &Basecall_Event::model_state);
+                return res;
+            }();
         return m;
     }
 }; // struct Basecall_Event
@@ -432,22 +420,11 @@ struct Basecall_Events_Params
     }
     void read(hdf5_tools::File const & f, std::string const & p)
     {
-        if (f.attribute_exists(p + "/start_time"))
-        {
-            f.read(p + "/start_time", start_time);
-        }
-        else
-        {
-            start_time = 0.0;
-        }
-        if (f.attribute_exists(p + "/duration"))
-        {
-            f.read(p + "/duration", duration);
-        }
-        else
-        {
-            duration = 0.0;
-        }
+        start_time = 0.0;
+        duration = 0.0;
+        f.read_attributes(p, {
+                { "start_time", start_time, false },
+                { "duration", duration, false } });
     }
     void write(hdf5_tools::File const & f, std::string const & p) const
     {
@@ -499,13 +476,14 @@ struct Basecall_Events_Pack
         move_params = f.get_attr_map(p + "/Move");
         f.read(p + "/P_Model_State", p_model_state);
         p_model_state_params = f.get_attr_map(p + "/P_Model_State");
-        f.read(p + "/name", name);
-        f.read(p + "/version", version);
-        f.read(p + "/ed_gr", ed_gr);
-        f.read(p + "/start_time", start_time);
-        f.read(p + "/state_size", state_size);
-        f.read(p + "/median_sd_temp", median_sd_temp);
-        f.read(p + "/p_model_state_bits", p_model_state_bits);
+        f.read_attributes(p, {
+                { "name", name },
+                { "version", version },
+                { "ed_gr", ed_gr },
+                { "start_time", start_time },
+                { "state_size", state_size },
+                { "median_sd_temp", median_sd_temp },
+                { "p_model_state_bits", p_model_state_bits } });
         params.read(f, p + "/params");
     }
     void write(hdf5_tools::File const & f, std::string const & p) const
@@ -555,15 +533,14 @@ struct Basecall_Alignment_Entry
     }
     static hdf5_tools::Compound_Map const & compound_map()
     {
-        static hdf5_tools::Compound_Map m;
-        static bool inited = false;
-        if (not inited)
-        {
-            m.add_member("template", &Basecall_Alignment_Entry::template_index);
-            m.add_member("complement", &Basecall_Alignment_Entry::complement_index);
-            m.add_member("kmer", &Basecall_Alignment_Entry::kmer);
-            inited = true;
-        }
+        static hdf5_tools::Compound_Map const m = [] ()
+            {
+                hdf5_tools::Compound_Map res;
+                res.add_member("template", &Basecall_Alignment_Entry::template_index);
+                res.add_member("complement", &Basecall_Alignment_Entry::complement_index);
+                res.add_member("kmer", &Basecall_Alignment_Entry::kmer);
+                return res;
+            }();
         return m;
     }
 }; // struct Basecall_Alignment_Entry
@@ -588,9 +565,10 @@ struct Basecall_Alignment_Pack
         complement_step_params = f.get_attr_map(p + "/Complement_Step");
         f.read(p + "/Move", move);
         move_params = f.get_attr_map(p + "/Move");
-        f.read(p + "/template_index_start", template_index_start);
-        f.read(p + "/complement_index_start", complement_index_start);
-        f.read(p + "/kmer_size", kmer_size);
+        f.read_attributes(p, {
+                { "template_index_start", template_index_start },
+                { "complement_index_start", complement_index_start },
+                { "kmer_size", kmer_size } });
     }
     void write(hdf5_tools::File const & f, std::string const & p) const
     {
@@ -626,25 +604,98 @@ struct Basecall_Group_Description
     {}
 }; // struct Basecall_Group_Description
 
+//
+// A dataset fetched from a file but not yet decoded: the unpacked dataset if
+// stored unpacked, otherwise its pack. Decoding a fetched dataset (see
+// File::decode_*) makes no HDF5 calls, so it can run on any thread.
+//
+template < typename Dataset_Type, typename Pack_Type >
+struct Fetched_Dataset
+{
+    bool packed;
+    Dataset_Type dataset;
+    Pack_Type pack;
+    Fetched_Dataset() : packed(false) {}
+}; // struct Fetched_Dataset
+
+typedef Fetched_Dataset< Raw_Int_Samples_Dataset, Raw_Samples_Pack > Raw_Samples_Fetch;
+typedef Fetched_Dataset< EventDetection_Events_Dataset, EventDetection_Events_Pack > EventDetection_Events_Fetch;
+typedef Fetched_Dataset< std::string, Basecall_Fastq_Pack > Basecall_Fastq_Fetch;
+typedef Fetched_Dataset< Basecall_Events_Dataset, Basecall_Events_Pack > Basecall_Events_Fetch;
+typedef Fetched_Dataset< std::vector< Basecall_Alignment_Entry >, Basecall_Alignment_Pack > Basecall_Alignment_Fetch;
+
+//
+// All datasets of a file, fetched but not decoded.
+// Keys: raw samples by read name; eventdetection events by (group, read name);
+// basecall fastq and events by (group, strand), where events are keyed by
+// the 1D group that stores them; basecall alignment by group.
+//
+struct File_Fetch
+{
+    std::string file_name;
+    Channel_Id_Params channel_id_params;
+    std::map< std::string, Raw_Samples_Fetch > raw_samples;
+    std::map< std::pair< std::string, std::string >, EventDetection_Events_Fetch > eventdetection_events;
+    std::map< std::pair< std::string, unsigned >, Basecall_Fastq_Fetch > basecall_fastq;
+    std::map< std::pair< std::string, unsigned >, Basecall_Events_Fetch > basecall_events;
+    std::map< std::string, Basecall_Alignment_Fetch > basecall_alignment;
+}; // struct File_Fetch
+
+//
+// All datasets of a file, decoded. Keys as in File_Fetch.
+//
+struct File_Contents
+{
+    std::string file_name;
+    Channel_Id_Params channel_id_params;
+    std::map< std::string, Raw_Samples_Dataset > raw_samples;
+    std::map< std::pair< std::string, std::string >, EventDetection_Events_Dataset > eventdetection_events;
+    std::map< std::pair< std::string, unsigned >, std::string > basecall_fastq;
+    std::map< std::pair< std::string, unsigned >, Basecall_Events_Dataset > basecall_events;
+    std::map< std::string, std::vector< Basecall_Alignment_Entry > > basecall_alignment;
+}; // struct File_Contents
+
 class File
     : private hdf5_tools::File
 {
 private:
     typedef hdf5_tools::File Base;
 public:
+    //
+    // Open flags: the sections of the file catalog an open file gives access to.
+    // Sections are discovered lazily, on first access, so a section that is never used costs
+    // nothing; sections left out appear empty. The file version, channel and tracking ids,
+    // and the read list of multi-read files are always accessible.
+    // With open_swmr, the file is opened in SWMR mode, for reading while a writer appends
+    // raw samples; see refresh().
+    //
+    enum Open_Flags
+    {
+        open_raw = 1,            ///< raw samples
+        open_eventdetection = 2, ///< eventdetection groups
+        open_basecall = 4,       ///< basecall groups
+        open_swmr = 8,           ///< SWMR mode; not a catalog section
+        open_metadata_only = 0,
+        open_raw_only = open_raw,
+        open_all = open_raw | open_eventdetection | open_basecall
+    };
+
     //
     // Constructors
     //
     File() = default;
-    File(std::string const & file_name, bool rw = false) { open(file_name, rw); }
+    File(std::string const & file_name, bool rw = false, unsigned flags = open_all) { open(file_name, rw, flags); }
 
     //
     // Base methods
     //
     using Base::is_open;
     using Base::is_rw;
+    using Base::is_swmr;
+    using Base::start_swmr_write;
+    using Base::flush;
     using Base::file_name;
-    using Base::create;
+    using Base::get_image;
     using Base::close;
     using Base::get_object_count;
     using Base::is_valid_file;
@@ -653,10 +704,154 @@ public:
     // Base method wrappers
     //
     void
-    open(std::string const & file_name, bool rw = false)
+    open(std::string const & file_name, bool rw = false, unsigned flags = open_all)
+    {
+        Base::open(file_name, rw, flags & open_swmr);
+        reset_cache(std::string(), flags);
+    }
+    void
+    open_in_memory(std::string const & file_name, unsigned flags = open_all)
+    {
+        Base::open_in_memory(file_name);
+        reset_cache(std::string(), flags);
+    }
+    void
+    open_image(void const * image_ptr, size_t image_size, std::string const & file_name,
+               unsigned flags = open_all)
+    {
+        Base::open_image(image_ptr, image_size, file_name);
+        reset_cache(std::string(), flags);
+    }
+    void
+    open_image(std::vector< char > const & image, std::string const & file_name, unsigned flags = open_all)
+    {
+        Base::open_image(image, file_name);
+        reset_cache(std::string(), flags);
+    }
+    void
+    create(std::string const & file_name, bool truncate = false, bool in_memory = false, bool swmr = false)
+    {
+        Base::create(file_name, truncate, in_memory, swmr);
+        reset_cache(std::string(), open_all);
+    }
+    /**
+     * Refresh a file open for SWMR reading, to see the raw samples appended by the writer
+     * since the file was opened or last refreshed, without reopening it.
+     * Only objects created before the writer started SWMR mode are guaranteed to be visible.
+     */
+    void
+    refresh()
+    {
+        for (auto const & rn : get_raw_samples_read_name_list())
+        {
+            auto && _rn = fill_raw_samples_read_name(rn);
+            if (have_raw_samples_unpack(_rn))
+            {
+                Base::refresh(raw_samples_path(_rn));
+                Base::refresh(raw_samples_params_path(_rn));
+            }
+            else if (have_raw_samples_pack(_rn))
+            {
+                Base::refresh(raw_samples_pack_path(_rn) + "/Signal");
+                Base::refresh(raw_samples_params_pack_path(_rn));
+            }
+        }
+        reset_cache(_read_id, _open_flags);
+    }
+    void
+    create_image(std::string const & file_name)
+    {
+        Base::create_image(file_name);
+        reset_cache(std::string(), open_all);
+    }
+
+    //
+    // Access multi-read files
+    //
+    // A multi-read file holds one group /read_<read_id> per read. A read view, opened
+    // with open_read(), shares the file, and accesses that read with the single-read API.
+    //
+    bool
+    is_multi_read() const
+    {
+        return not read_ids().empty();
+    }
+    std::vector< std::string > const &
+    get_read_id_list() const
+    {
+        return read_ids().list();
+    }
+    bool
+    have_read(std::string const & read_id) const
+    {
+        return read_ids().count(read_id);
+    }
+    /**
+     * Add an empty read group to a multi-read file open for writing.
+     * @param read_id Read id.
+     */
+    void
+    add_read(std::string const & read_id)
+    {
+        assert(not is_read_view());
+        if (read_id.empty() or have_read(read_id))
+        {
+            LOG_THROW
+                << "invalid or existing read id: read_id=" << read_id;
+        }
+        Base::create_group(read_group_path(read_id));
+        _read_ids.insert(read_id);
+        // reads are written through views, which the object index of this file would not see
+        Base::set_object_index_root(std::string());
+    }
+    /**
+     * Remove a read group, e.g. one left incomplete by an error.
+     * The space used by the read is not reclaimed.
+     * @param read_id Read id.
+     */
+    void
+    remove_read(std::string const & read_id)
+    {
+        assert(not is_read_view());
+        if (not have_read(read_id)) return;
+        Base::remove(read_group_path(read_id));
+        _read_ids.erase(read_id);
+    }
+    /**
+     * Open a view of one read in a multi-read file.
+     * The view shares the file and its access mode with @p f, and it must be closed before @p f.
+     * @param f Open multi-read file.
+     * @param read_id Read id.
+     * @param flags Open flags.
+     */
+    void
+    open_read(File const & f, std::string const & read_id, unsigned flags = open_all)
+    {
+        if (not f.have_read(read_id))
+        {
+            LOG_THROW
+                << f.file_name() << ": read not found: read_id=" << read_id;
+        }
+        Base::reopen(f);
+        reset_cache(read_id, flags);
+    }
+    bool
+    is_read_view() const
     {
-        Base::open(file_name, rw);
-        reload();
+        return not _read_id.empty();
+    }
+    /**
+     * Get the read id of the read accessed through this object.
+     * For a read view, this is the id of the read it was opened on; otherwise,
+     * it is taken from the raw samples or eventdetection params, if any.
+     */
+    std::string
+    get_read_id() const
+    {
+        if (is_read_view()) return _read_id;
+        if (have_raw_samples()) return get_raw_samples_params().read_id;
+        if (have_eventdetection_events()) return get_eventdetection_events_params().read_id;
+        return std::string();
     }
 
     //
@@ -669,6 +864,11 @@ public:
         Base::read(file_version_path(), res);
         return res;
     }
+    void
+    add_file_version(std::string const & v) const
+    {
+        Base::write_attribute(file_version_path(), v);
+    }
 
     //
     // Access /UniqueGlobalKey/channel_id
@@ -676,23 +876,24 @@ public:
     bool
     have_channel_id_params() const
     {
-        return _channel_id_params.sampling_rate > 0.0;
+        return channel_id_params().sampling_rate > 0.0;
     }
     Channel_Id_Params
     get_channel_id_params() const
     {
-        return _channel_id_params;
+        return channel_id_params();
     }
     void
     add_channel_id_params(Channel_Id_Params const & channel_id_params)
     {
         _channel_id_params = channel_id_params;
+        _channel_id_params_loaded = true;
         _channel_id_params.write(*this, channel_id_path());
     }
     bool
     have_sampling_rate() const { return have_channel_id_params(); }
     double
-    get_sampling_rate() const { return _channel_id_params.sampling_rate; }
+    get_sampling_rate() const { return channel_id_params().sampling_rate; }
 
     //
     // Access /UniqueGlobalKey/tracking_id
@@ -738,15 +939,16 @@ public:
     std::vector< std::string > const &
     get_raw_samples_read_name_list() const
     {
-        return _raw_samples_read_names;
+        return raw_samples_read_names().list();
     }
     bool
     have_raw_samples(std::string const & rn = std::string()) const
     {
-        auto && rn_l = get_raw_samples_read_name_list();
-        return (rn.empty()
+        // a read view holds at most one raw read, found under any read name
+        auto && rn_l = raw_samples_read_names();
+        return (rn.empty() or is_read_view()
                 ? not rn_l.empty()
-                : std::find(rn_l.begin(), rn_l.end(), rn) != rn_l.end());
+                : rn_l.count(rn));
     }
     bool
     have_raw_samples_unpack(std::string const & rn) const
@@ -799,7 +1001,7 @@ public:
     add_raw_samples(std::string const & rn, std::vector< Raw_Int_Sample > const & rsi)
     {
         Base::write_dataset(raw_samples_path(rn), rsi);
-        reload();
+        update_raw_samples_read_name(rn);
     }
     std::vector< Raw_Sample >
     get_raw_samples(std::string const & rn = std::string()) const
@@ -811,7 +1013,7 @@ public:
         res.reserve(rsi.size());
         for (auto int_level : rsi)
         {
-            res.push_back(raw_sample_to_float(int_level, _channel_id_params));
+            res.push_back(raw_sample_to_float(int_level, channel_id_params()));
         }
         return res;
     }
@@ -822,23 +1024,22 @@ public:
     std::vector< std::string > const &
     get_eventdetection_group_list() const
     {
-        return _eventdetection_groups;
+        return eventdetection_groups().list();
     }
     bool
     have_eventdetection_group(std::string const & gr = std::string()) const
     {
         return (gr.empty()
-                ? not _eventdetection_groups.empty()
-                : _eventdetection_read_names.count(gr));
+                ? not eventdetection_groups().empty()
+                : eventdetection_read_names().count(gr));
     }
     std::vector< std::string > const &
     get_eventdetection_read_name_list(std::string const & gr = std::string()) const
     {
         static const std::vector< std::string > _empty;
         auto && _gr = fill_eventdetection_group(gr);
-        return (_eventdetection_read_names.count(_gr)
-                ? _eventdetection_read_names.at(_gr)
-                : _empty);
+        auto rn_l_ptr = eventdetection_read_name_list_ptr(_gr);
+        return rn_l_ptr? rn_l_ptr->list() : _empty;
     }
     Attr_Map
     get_eventdetection_params(std::string const & gr = std::string()) const
@@ -861,12 +1062,8 @@ public:
     {
         auto && _gr = fill_eventdetection_group(gr);
         auto && _rn = fill_eventdetection_read_name(_gr, rn);
-        return (_eventdetection_read_names.count(_gr)
-                and std::find(
-                    _eventdetection_read_names.at(_gr).begin(),
-                    _eventdetection_read_names.at(_gr).end(),
-                    _rn)
-                != _eventdetection_read_names.at(_gr).end());
+        auto rn_l_ptr = eventdetection_read_name_list_ptr(_gr);
+        return rn_l_ptr and rn_l_ptr->count(_rn);
     }
     bool
     have_eventdetection_events_unpack(std::string const & gr, std::string const & rn) const
@@ -954,7 +1151,7 @@ public:
         std::vector< EventDetection_Event > const & ede)
     {
         Base::write_dataset(eventdetection_events_path(gr, rn), ede, EventDetection_Event::compound_map());
-        reload();
+        update_eventdetection_read_name(gr, rn);
     }
 
     //
@@ -963,20 +1160,20 @@ public:
     std::vector< std::string > const &
     get_basecall_group_list() const
     {
-        return _basecall_groups;
+        return basecall_groups().list();
     }
     bool
     have_basecall_group(std::string const & gr = std::string()) const
     {
-        auto && gr_l = get_basecall_group_list();
+        auto && gr_l = basecall_groups();
         return (gr.empty()
                 ? not gr_l.empty()
-                : std::find(gr_l.begin(), gr_l.end(), gr) != gr_l.end());
+                : gr_l.count(gr));
     }
     std::vector< std::string > const &
     get_basecall_strand_group_list(unsigned st) const
     {
-        return _basecall_strand_groups.at(st);
+        return basecall_strand_groups().at(st).list();
     }
     bool
     have_basecall_strand_group(unsigned st, std::string const & gr = std::string()) const
@@ -986,35 +1183,27 @@ public:
         {
             return not gr_l.empty();
         }
-        if (not _basecall_group_descriptions.count(gr))
-        {
-            return false;
-        }
-        else
-        {
-            return _basecall_group_descriptions.at(gr).have_subgroup[st];
-        }
+        auto bc_desc_ptr = basecall_group_description_ptr(gr);
+        return bc_desc_ptr and bc_desc_ptr->have_subgroup[st];
     }
     Basecall_Group_Description const &
     get_basecall_group_description(std::string const & gr) const
     {
-        return _basecall_group_descriptions.at(gr);
+        return basecall_group_descriptions().at(gr);
     }
     std::string const &
     get_basecall_1d_group(std::string const & gr) const
     {
         static std::string const empty;
-        return (_basecall_group_descriptions.count(gr)
-                ? _basecall_group_descriptions.at(gr).bc_1d_gr
-                : empty);
+        auto bc_desc_ptr = basecall_group_description_ptr(gr);
+        return bc_desc_ptr? bc_desc_ptr->bc_1d_gr : empty;
     }
     std::string const &
     get_basecall_eventdetection_group(std::string const & gr) const
     {
         static std::string const empty;
-        return (_basecall_group_descriptions.count(gr)
-                ? _basecall_group_descriptions.at(gr).ed_gr
-                : empty);
+        auto bc_desc_ptr = basecall_group_description_ptr(gr);
+        return bc_desc_ptr? bc_desc_ptr->ed_gr : empty;
     }
 
     //
@@ -1073,8 +1262,8 @@ public:
     have_basecall_fastq(unsigned st, std::string const & gr = std::string()) const
     {
         auto && _gr = fill_basecall_group(st, gr);
-        return (_basecall_group_descriptions.count(_gr)
-                and _basecall_group_descriptions.at(_gr).have_fastq[st]);
+        auto bc_desc_ptr = basecall_group_description_ptr(_gr);
+        return bc_desc_ptr and bc_desc_ptr->have_fastq[st];
     }
     bool
     have_basecall_fastq_unpack(unsigned st, std::string const & gr) const
@@ -1106,7 +1295,7 @@ public:
     add_basecall_fastq(unsigned st, std::string const & gr, std::string const & fq)
     {
         Base::write(basecall_fastq_path(gr, st), true, fq);
-        reload();
+        update_basecall_group(gr);
     }
     bool
     have_basecall_seq(unsigned st, std::string const & _gr = std::string()) const
@@ -1128,7 +1317,6 @@ public:
             << "+\n"
             << std::string(seq.size(), (char)default_qual);
         add_basecall_fastq(st, gr, oss.str());
-        reload();
     }
 
     //
@@ -1138,8 +1326,8 @@ public:
     have_basecall_model(unsigned st, std::string const & gr = std::string()) const
     {
         auto && gr_1d = fill_basecall_1d_group(st, gr);
-        return (_basecall_group_descriptions.count(gr_1d)
-                and _basecall_group_descriptions.at(gr_1d).have_model[st]);
+        auto bc_desc_ptr = basecall_group_description_ptr(gr_1d);
+        return bc_desc_ptr and bc_desc_ptr->have_model[st];
     }
     std::string
     get_basecall_model_file(unsigned st, std::string const & gr = std::string()) const
@@ -1182,7 +1370,7 @@ public:
     {
         auto && gr_1d = get_basecall_1d_group(gr);
         Base::write_dataset(basecall_model_path(gr_1d, st), mod, Basecall_Model_State::compound_map());
-        reload();
+        update_basecall_group(gr_1d);
     }
 
     //
@@ -1192,8 +1380,8 @@ public:
     have_basecall_events(unsigned st, std::string const & gr = std::string()) const
     {
         auto && gr_1d = fill_basecall_1d_group(st, gr);
-        return (_basecall_group_descriptions.count(gr_1d)
-                and _basecall_group_descriptions.at(gr_1d).have_events[st]);
+        auto bc_desc_ptr = basecall_group_description_ptr(gr_1d);
+        return bc_desc_ptr and bc_desc_ptr->have_events[st];
     }
     bool
     have_basecall_events_unpack(unsigned st, std::string const & gr) const
@@ -1261,7 +1449,7 @@ public:
                         << " ed_gr=" << ev_pack.ed_gr;
                 }
                 auto ed = get_eventdetection_events(ev_pack.ed_gr);
-                res = unpack_ev(ev_pack, sq, ed, _channel_id_params).first;
+                res = unpack_ev(ev_pack, sq, ed, channel_id_params()).first;
             }
             else // ed_gr == "": packed relative to raw samples
             {
@@ -1273,7 +1461,7 @@ public:
                 }
                 auto rs_ds = get_raw_samples_dataset();
                 auto ed = unpack_implicit_ed(ev_pack, rs_ds);
-                res = unpack_ev(ev_pack, sq, ed, _channel_id_params).first;
+                res = unpack_ev(ev_pack, sq, ed, channel_id_params()).first;
             }
         }
         return res;
@@ -1283,7 +1471,7 @@ public:
     add_basecall_events(unsigned st, std::string const & gr, std::vector< T > const & ev)
     {
         Base::write_dataset(basecall_events_path(gr, st), ev, T::compound_map());
-        reload();
+        update_basecall_group(gr);
     }
 
     //
@@ -1293,8 +1481,8 @@ public:
     have_basecall_alignment(std::string const & gr = std::string()) const
     {
         auto && _gr = fill_basecall_group(2, gr);
-        return (_basecall_group_descriptions.count(_gr)
-                and _basecall_group_descriptions.at(_gr).have_alignment);
+        auto bc_desc_ptr = basecall_group_description_ptr(_gr);
+        return bc_desc_ptr and bc_desc_ptr->have_alignment;
     }
     bool
     have_basecall_alignment_unpack(std::string const & gr) const
@@ -1328,9 +1516,277 @@ public:
     add_basecall_alignment(std::string const & gr, std::vector< Basecall_Alignment_Entry > const & al)
     {
         Base::write_dataset(basecall_alignment_path(gr), al, Basecall_Alignment_Entry::compound_map());
-        reload();
+        update_basecall_group(gr);
     }
 
+    //
+    // Two-phase access
+    //
+    // Phase one (fetch_*) reads datasets as stored, packed or not, and makes
+    // all the HDF5 calls. Phase two (decode_*) is static and pure: it makes no
+    // HDF5 calls, so one thread can fetch while many others decode.
+    //
+    Raw_Samples_Fetch
+    fetch_raw_samples(std::string const & rn = std::string()) const
+    {
+        Raw_Samples_Fetch res;
+        auto && _rn = fill_raw_samples_read_name(rn);
+        if (have_raw_samples_unpack(_rn))
+        {
+            Base::read(raw_samples_path(_rn), res.dataset.first);
+            res.dataset.second = get_raw_samples_params(_rn);
+        }
+        else if (have_raw_samples_pack(_rn))
+        {
+            res.packed = true;
+            res.pack = get_raw_samples_pack(_rn);
+        }
+        return res;
+    }
+    EventDetection_Events_Fetch
+    fetch_eventdetection_events(
+        std::string const & gr = std::string(), std::string const & rn = std::string()) const
+    {
+        EventDetection_Events_Fetch res;
+        auto && _gr = fill_eventdetection_group(gr);
+        auto && _rn = fill_eventdetection_read_name(_gr, rn);
+        if (have_eventdetection_events_unpack(_gr, _rn))
+        {
+            res.dataset = get_eventdetection_events_dataset(_gr, _rn);
+        }
+        else if (have_eventdetection_events_pack(_gr, _rn))
+        {
+            res.packed = true;
+            res.pack = get_eventdetection_events_pack(_gr, _rn);
+        }
+        return res;
+    }
+    Basecall_Fastq_Fetch
+    fetch_basecall_fastq(unsigned st, std::string const & gr = std::string()) const
+    {
+        Basecall_Fastq_Fetch res;
+        auto && _gr = fill_basecall_group(st, gr);
+        if (have_basecall_fastq_unpack(st, _gr))
+        {
+            Base::read(basecall_fastq_path(_gr, st), res.dataset);
+        }
+        else if (have_basecall_fastq_pack(st, _gr))
+        {
+            res.packed = true;
+            res.pack = get_basecall_fastq_pack(st, _gr);
+        }
+        return res;
+    }
+    Basecall_Events_Fetch
+    fetch_basecall_events(unsigned st, std::string const & gr = std::string()) const
+    {
+        Basecall_Events_Fetch res;
+        auto && gr_1d = fill_basecall_1d_group(st, gr);
+        if (have_basecall_events_unpack(st, gr_1d))
+        {
+            res.dataset = get_basecall_events_dataset(st, gr_1d);
+        }
+        else if (have_basecall_events_pack(st, gr_1d))
+        {
+            res.packed = true;
+            res.pack = get_basecall_events_pack(st, gr_1d);
+        }
+        return res;
+    }
+    Basecall_Alignment_Fetch
+    fetch_basecall_alignment(std::string const & gr = std::string()) const
+    {
+        Basecall_Alignment_Fetch res;
+        auto && _gr = fill_basecall_group(2, gr);
+        if (have_basecall_alignment_unpack(_gr))
+        {
+            res.dataset = get_basecall_alignment(_gr);
+        }
+        else if (have_basecall_alignment_pack(_gr))
+        {
+            res.packed = true;
+            res.pack = get_basecall_alignment_pack(_gr);
+        }
+        return res;
+    }
+    File_Fetch
+    fetch() const
+    {
+        File_Fetch res;
+        res.file_name = file_name();
+        res.channel_id_params = channel_id_params();
+        for (auto const & rn : get_raw_samples_read_name_list())
+        {
+            res.raw_samples[rn] = fetch_raw_samples(rn);
+        }
+        for (auto const & gr : get_eventdetection_group_list())
+        {
+            for (auto const & rn : get_eventdetection_read_name_list(gr))
+            {
+                if (not have_eventdetection_events(gr, rn)) continue;
+                res.eventdetection_events[std::make_pair(gr, rn)] = fetch_eventdetection_events(gr, rn);
+            }
+        }
+        for (auto const & gr : get_basecall_group_list())
+        {
+            for (unsigned st = 0; st < 3; ++st)
+            {
+                if (have_basecall_fastq_unpack(st, gr) or have_basecall_fastq_pack(st, gr))
+                {
+                    res.basecall_fastq[std::make_pair(gr, st)] = fetch_basecall_fastq(st, gr);
+                }
+                if (have_basecall_events_unpack(st, gr) or have_basecall_events_pack(st, gr))
+                {
+                    res.basecall_events[std::make_pair(gr, st)] = fetch_basecall_events(st, gr);
+                }
+            }
+            if (have_basecall_alignment_unpack(gr) or have_basecall_alignment_pack(gr))
+            {
+                res.basecall_alignment[gr] = fetch_basecall_alignment(gr);
+            }
+        }
+        return res;
+    } // fetch()
+    static Raw_Samples_Dataset
+    decode_raw_samples(Raw_Samples_Fetch const & rs_fetch, Channel_Id_Params const & cid_params)
+    {
+        Raw_Samples_Dataset res;
+        Raw_Int_Samples_Dataset rsi_ds_unpack;
+        if (rs_fetch.packed) rsi_ds_unpack = unpack_rw(rs_fetch.pack);
+        auto const & rsi_ds = rs_fetch.packed? rsi_ds_unpack : rs_fetch.dataset;
+        res.first.reserve(rsi_ds.first.size());
+        for (auto int_level : rsi_ds.first)
+        {
+            res.first.push_back(raw_sample_to_float(int_level, cid_params));
+        }
+        res.second = rsi_ds.second;
+        return res;
+    }
+    static EventDetection_Events_Dataset
+    decode_eventdetection_events(EventDetection_Events_Fetch const & ede_fetch,
+                                 Raw_Samples_Dataset const & rs_ds)
+    {
+        return (ede_fetch.packed
+                ? unpack_ed(ede_fetch.pack, rs_ds)
+                : ede_fetch.dataset);
+    }
+    static std::string
+    decode_basecall_fastq(Basecall_Fastq_Fetch const & fq_fetch)
+    {
+        return fq_fetch.packed? unpack_fq(fq_fetch.pack) : fq_fetch.dataset;
+    }
+    /**
+     * Decode basecall events.
+     * @param ev_fetch Fetched events.
+     * @param sq Basecall sequence of the same group and strand.
+     * @param ed Eventdetection events of the group the events were packed against; unused if packed
+     * relative to raw samples.
+     * @param rs_ds Raw samples; used only if packed relative to raw samples.
+     * @param cid_params Channel id params.
+     */
+    static Basecall_Events_Dataset
+    decode_basecall_events(Basecall_Events_Fetch const & ev_fetch,
+                           std::string const & sq,
+                           std::vector< EventDetection_Event > const & ed,
+                           Raw_Samples_Dataset const & rs_ds,
+                           Channel_Id_Params const & cid_params)
+    {
+        if (not ev_fetch.packed) return ev_fetch.dataset;
+        if (not ev_fetch.pack.ed_gr.empty())
+        {
+            return unpack_ev(ev_fetch.pack, sq, ed, cid_params);
+        }
+        else
+        {
+            return unpack_ev(ev_fetch.pack, sq, unpack_implicit_ed(ev_fetch.pack, rs_ds), cid_params);
+        }
+    }
+    static std::vector< Basecall_Alignment_Entry >
+    decode_basecall_alignment(Basecall_Alignment_Fetch const & al_fetch, std::string const & sq)
+    {
+        return al_fetch.packed? unpack_al(al_fetch.pack, sq) : al_fetch.dataset;
+    }
+    /**
+     * Decode all datasets of a file.
+     * Dependencies between packed datasets are resolved as by the get_* methods:
+     * default read names are the first ones, in name order.
+     */
+    static File_Contents
+    decode(File_Fetch const & f_fetch)
+    {
+        File_Contents res;
+        res.file_name = f_fetch.file_name;
+        res.channel_id_params = f_fetch.channel_id_params;
+        for (auto const & p : f_fetch.raw_samples)
+        {
+            res.raw_samples[p.first] = decode_raw_samples(p.second, f_fetch.channel_id_params);
+        }
+        static Raw_Samples_Dataset const empty_rs_ds;
+        static std::vector< EventDetection_Event > const empty_ed;
+        auto get_rs_ds = [&] (std::string const & rn) -> Raw_Samples_Dataset const & {
+            auto it = rn.empty()? res.raw_samples.begin() : res.raw_samples.find(rn);
+            return it != res.raw_samples.end()? it->second : empty_rs_ds;
+        };
+        for (auto const & p : f_fetch.eventdetection_events)
+        {
+            if (p.second.packed and res.raw_samples.count(p.first.second) == 0)
+            {
+                LOG_THROW_(std::logic_error)
+                    << "missing raw samples required to unpack eventdetection events: gr=" << p.first.first
+                    << " rn=" << p.first.second;
+            }
+            res.eventdetection_events[p.first] = decode_eventdetection_events(p.second, get_rs_ds(p.first.second));
+        }
+        for (auto const & p : f_fetch.basecall_fastq)
+        {
+            res.basecall_fastq[p.first] = decode_basecall_fastq(p.second);
+        }
+        for (auto const & p : f_fetch.basecall_events)
+        {
+            std::string sq;
+            std::vector< EventDetection_Event > const * ed_ptr = &empty_ed;
+            if (p.second.packed)
+            {
+                if (res.basecall_fastq.count(p.first) == 0)
+                {
+                    LOG_THROW_(std::logic_error)
+                        << "missing fastq required to unpack basecall events: st=" << p.first.second
+                        << " gr=" << p.first.first;
+                }
+                sq = fq2seq(res.basecall_fastq.at(p.first));
+                auto const & ed_gr = p.second.pack.ed_gr;
+                if (not ed_gr.empty())
+                {
+                    auto it = res.eventdetection_events.lower_bound(std::make_pair(ed_gr, std::string()));
+                    if (it == res.eventdetection_events.end() or it->first.first != ed_gr)
+                    {
+                        LOG_THROW_(std::logic_error)
+                            << "missing eventdetection events required to unpack basecall events: st=" << p.first.second
+                            << " gr=" << p.first.first
+                            << " ed_gr=" << ed_gr;
+                    }
+                    ed_ptr = &it->second.first;
+                }
+                else if (res.raw_samples.empty())
+                {
+                    LOG_THROW_(std::logic_error)
+                        << "missing raw samples required to unpack basecall events: st=" << p.first.second
+                        << " gr=" << p.first.first;
+                }
+            }
+            res.basecall_events[p.first] = decode_basecall_events(
+                p.second, sq, *ed_ptr, get_rs_ds(std::string()), f_fetch.channel_id_params);
+        }
+        for (auto const & p : f_fetch.basecall_alignment)
+        {
+            auto it = res.basecall_fastq.find(std::make_pair(p.first, 2u));
+            if (p.second.packed and it == res.basecall_fastq.end()) continue;
+            res.basecall_alignment[p.first] = decode_basecall_alignment(
+                p.second, it != res.basecall_fastq.end()? fq2seq(it->second) : std::string());
+        }
+        return res;
+    } // decode()
+
     //
     // Static helpers
     //
@@ -1383,52 +1839,231 @@ public:
 
 private:
     friend struct File_Packer;
+    friend class Read_Index;
+    friend class Pack_Archive;
+    friend class Raw_Samples_Writer;
+
+    std::string _read_id;
+    unsigned _open_flags = open_all;
+
+    /**
+     * List of names in insertion order, with a hash index for constant time lookups.
+     * Used for the catalogs of reads and groups, which can hold thousands of entries.
+     */
+    class Name_List
+    {
+    public:
+        std::vector< std::string > const & list() const { return _list; }
+        bool empty() const { return _list.empty(); }
+        std::string const & front() const { return _list.front(); }
+        bool count(std::string const & name) const { return _index.count(name) > 0; }
+        /// Append name, unless it is already present.
+        void insert(std::string const & name)
+        {
+            if (_index.insert(name).second) _list.push_back(name);
+        }
+        /// Remove name, if present.
+        void erase(std::string const & name)
+        {
+            if (_index.erase(name)) _list.erase(std::find(_list.begin(), _list.end(), name));
+        }
+        void clear()
+        {
+            _list.clear();
+            _index.clear();
+        }
+    private:
+        std::vector< std::string > _list;
+        std::unordered_set< std::string > _index;
+    }; // class Name_List
 
     //
-    // Cached file data
+    // Cached file data, in sections loaded on first access
     //
-    Channel_Id_Params _channel_id_params;
-    std::vector< std::string > _raw_samples_read_names;
-    std::vector< std::string > _eventdetection_groups;
-    std::map< std::string, std::vector< std::string > > _eventdetection_read_names;
-    std::vector< std::string > _basecall_groups;
-    std::map< std::string, Basecall_Group_Description > _basecall_group_descriptions;
-    std::array< std::vector< std::string >, 3 > _basecall_strand_groups;
+    mutable bool _read_ids_loaded = false;
+    mutable Name_List _read_ids;
+    mutable bool _channel_id_params_loaded = false;
+    mutable Channel_Id_Params _channel_id_params;
+    mutable bool _raw_samples_read_names_loaded = false;
+    mutable Name_List _raw_samples_read_names;
+    mutable bool _eventdetection_groups_loaded = false;
+    mutable Name_List _eventdetection_groups;
+    mutable std::unordered_map< std::string, Name_List > _eventdetection_read_names;
+    mutable bool _basecall_groups_loaded = false;
+    mutable Name_List _basecall_groups;
+    mutable std::unordered_map< std::string, Basecall_Group_Description > _basecall_group_descriptions;
+    mutable std::array< Name_List, 3 > _basecall_strand_groups;
 
     //
-    // Cache updaters
+    // Cache accessors: load a section on first access. A section is marked as loaded
+    // before it is loaded, as loading basecall groups looks up the ones found so far.
     //
+    Name_List const &
+    read_ids() const
+    {
+        if (not _read_ids_loaded)
+        {
+            _read_ids_loaded = true;
+            load_read_ids();
+        }
+        return _read_ids;
+    }
+    Channel_Id_Params const &
+    channel_id_params() const
+    {
+        if (not _channel_id_params_loaded)
+        {
+            _channel_id_params_loaded = true;
+            load_channel_id_params();
+        }
+        return _channel_id_params;
+    }
+    Name_List const &
+    raw_samples_read_names() const
+    {
+        if (not _raw_samples_read_names_loaded)
+        {
+            _raw_samples_read_names_loaded = true;
+            if (_open_flags & open_raw) load_raw_samples_read_names();
+        }
+        return _raw_samples_read_names;
+    }
     void
-    reload()
+    ensure_eventdetection_groups() const
+    {
+        if (not _eventdetection_groups_loaded)
+        {
+            _eventdetection_groups_loaded = true;
+            if (_open_flags & open_eventdetection) load_eventdetection_groups();
+        }
+    }
+    Name_List const &
+    eventdetection_groups() const
     {
-        load_channel_id_params();
-        load_raw_samples_read_names();
-        load_eventdetection_groups();
-        load_basecall_groups();
+        ensure_eventdetection_groups();
+        return _eventdetection_groups;
+    }
+    std::unordered_map< std::string, Name_List > const &
+    eventdetection_read_names() const
+    {
+        ensure_eventdetection_groups();
+        return _eventdetection_read_names;
+    }
+    Name_List const *
+    eventdetection_read_name_list_ptr(std::string const & gr) const
+    {
+        auto it = eventdetection_read_names().find(gr);
+        return it != _eventdetection_read_names.end()? &it->second : nullptr;
     }
     void
-    load_channel_id_params()
+    ensure_basecall_groups() const
+    {
+        if (not _basecall_groups_loaded)
+        {
+            _basecall_groups_loaded = true;
+            if (_open_flags & open_basecall) load_basecall_groups();
+        }
+    }
+    Name_List const &
+    basecall_groups() const
+    {
+        ensure_basecall_groups();
+        return _basecall_groups;
+    }
+    std::unordered_map< std::string, Basecall_Group_Description > const &
+    basecall_group_descriptions() const
     {
+        ensure_basecall_groups();
+        return _basecall_group_descriptions;
+    }
+    Basecall_Group_Description const *
+    basecall_group_description_ptr(std::string const & gr) const
+    {
+        auto it = basecall_group_descriptions().find(gr);
+        return it != _basecall_group_descriptions.end()? &it->second : nullptr;
+    }
+    std::array< Name_List, 3 > const &
+    basecall_strand_groups() const
+    {
+        ensure_basecall_groups();
+        return _basecall_strand_groups;
+    }
+
+    //
+    // Cache loaders
+    //
+    void
+    reset_cache(std::string const & read_id, unsigned flags)
+    {
+        _read_id = read_id;
+        _open_flags = flags;
+        Base::set_object_index_root(read_id.empty()? std::string("/") : read_group_path(read_id));
+        _read_ids_loaded = false;
+        _read_ids.clear();
+        _channel_id_params_loaded = false;
+        _channel_id_params = Channel_Id_Params();
+        _raw_samples_read_names_loaded = false;
+        _raw_samples_read_names.clear();
+        _eventdetection_groups_loaded = false;
+        _eventdetection_groups.clear();
+        _eventdetection_read_names.clear();
+        _basecall_groups_loaded = false;
+        _basecall_groups.clear();
+        _basecall_group_descriptions.clear();
+        for (auto & v : _basecall_strand_groups) v.clear();
+    }
+    void
+    load_read_ids() const
+    {
+        _read_ids.clear();
+        if (is_read_view()) return;
+        auto rd_gr_prefix = read_group_prefix();
+        auto gr_l = Base::list_group("/");
+        for (auto const & g : gr_l)
+        {
+            if (g.substr(0, rd_gr_prefix.size()) != rd_gr_prefix) continue;
+            _read_ids.insert(g.substr(rd_gr_prefix.size()));
+        }
+        // in a multi-read file, the object index is kept by the read views
+        if (not _read_ids.empty()) Base::set_object_index_root(std::string());
+    }
+    void
+    load_channel_id_params() const
+    {
+        _channel_id_params = Channel_Id_Params();
         if (not Base::group_exists(channel_id_path())) return;
         _channel_id_params.read(*this, channel_id_path());
     }
     void
-    load_raw_samples_read_names()
+    load_raw_samples_read_names() const
     {
         _raw_samples_read_names.clear();
-        if (not Base::group_exists(raw_samples_root_path())) return;
-        auto rn_l = Base::list_group(raw_samples_root_path());
-        for (auto const & rn : rn_l)
+        if (is_read_view())
         {
-            if (have_raw_samples_unpack(rn)
-                or have_raw_samples_pack(rn))
+            // the raw read of a read view is listed under its read id
+            if (Base::dataset_exists(raw_samples_path(_read_id))
+                or Base::group_exists(raw_samples_pack_path(_read_id)))
+            {
+                _raw_samples_read_names.insert(_read_id);
+            }
+            return;
+        }
+        if (not Base::group_exists(raw_samples_root_path())) return;
+        auto rn_l = Base::list_group_types(raw_samples_root_path());
+        for (auto const & p : rn_l)
+        {
+            if (p.second != hdf5_tools::H5O_TYPE_GROUP) continue;
+            auto const & rn = p.first;
+            auto sg_l = Base::list_group_types(raw_samples_params_path(rn));
+            if (have_child(sg_l, raw_samples_path(rn), hdf5_tools::H5O_TYPE_DATASET)
+                or have_child(sg_l, raw_samples_pack_path(rn), hdf5_tools::H5O_TYPE_GROUP))
             {
-                _raw_samples_read_names.push_back(rn);
+                _raw_samples_read_names.insert(rn);
             }
         }
     }
     void
-    load_eventdetection_groups()
+    load_eventdetection_groups() const
     {
         _eventdetection_groups.clear();
         _eventdetection_read_names.clear();
@@ -1439,96 +2074,179 @@ private:
         {
             if (g.substr(0, ed_gr_prefix.size()) != ed_gr_prefix) continue;
             std::string gr = g.substr(ed_gr_prefix.size());
-            _eventdetection_groups.push_back(gr);
+            _eventdetection_groups.insert(gr);
             _eventdetection_read_names[gr] = detect_eventdetection_read_names(gr);
         }
     }
-    std::vector< std::string >
+    Name_List
     detect_eventdetection_read_names(std::string const & gr) const
     {
-        std::vector< std::string > res;
+        Name_List res;
         std::string p = eventdetection_root_path() + "/" + eventdetection_group_prefix() + gr + "/Reads";
         if (not Base::group_exists(p)) return res;
-        auto rn_l = Base::list_group(p);
-        for (auto const & rn : rn_l)
-        {
-            if (have_eventdetection_events_unpack(gr, rn)
-                or have_eventdetection_events_pack(gr, rn))
+        auto rn_l = Base::list_group_types(p);
+        for (auto const & rn_p : rn_l)
+        {
+            if (rn_p.second != hdf5_tools::H5O_TYPE_GROUP) continue;
+            auto const & rn = rn_p.first;
+            auto sg_l = Base::list_group_types(eventdetection_events_params_path(gr, rn));
+            if (have_child(sg_l, eventdetection_events_path(gr, rn), hdf5_tools::H5O_TYPE_DATASET)
+                or have_child(sg_l, eventdetection_events_pack_path(gr, rn), hdf5_tools::H5O_TYPE_GROUP))
             {
-                res.push_back(rn);
+                res.insert(rn);
             }
         }
         return res;
     }
     void
-    load_basecall_groups()
+    load_basecall_groups() const
     {
         _basecall_groups.clear();
         _basecall_group_descriptions.clear();
-        std::for_each(
-            _basecall_strand_groups.begin(), _basecall_strand_groups.end(),
-            [] (decltype(_basecall_strand_groups)::value_type & v) {
-                v.clear();
-            });
-        if (not Base::group_exists(basecall_root_path())) return;
-        auto bc_gr_prefix = basecall_group_prefix();
-        auto gr_l = Base::list_group(basecall_root_path());
-        for (auto const & g : gr_l)
+        if (Base::group_exists(basecall_root_path()))
         {
-            if (g.substr(0, bc_gr_prefix.size()) != bc_gr_prefix) continue;
-            // found basecall group
-            std::string gr = g.substr(bc_gr_prefix.size());
-            _basecall_groups.push_back(gr);
-            // name and version
-            _basecall_group_descriptions[gr] = detect_basecall_group_id(gr);
-            auto & bc_desc = _basecall_group_descriptions.at(gr);
-            // subgroups
-            for (unsigned st = 0; st < 3; ++st)
+            auto bc_gr_prefix = basecall_group_prefix();
+            auto gr_l = Base::list_group_types(basecall_root_path());
+            for (auto const & g_p : gr_l)
             {
-                bc_desc.have_subgroup[st] =
-                    Base::group_exists(basecall_strand_group_path(gr, st));
-                if (bc_desc.have_subgroup[st])
+                auto const & g = g_p.first;
+                if (g_p.second != hdf5_tools::H5O_TYPE_GROUP
+                    or g.substr(0, bc_gr_prefix.size()) != bc_gr_prefix) continue;
+                // found basecall group
+                std::string gr = g.substr(bc_gr_prefix.size());
+                _basecall_groups.insert(gr);
+                load_basecall_group(gr);
+            }
+        }
+        load_basecall_strand_groups();
+    }
+    void
+    load_basecall_group(std::string const & gr) const
+    {
+        Basecall_Group_Description bc_desc = detect_basecall_group_id(gr);
+        // subgroups
+        auto sg_l = Base::list_group_types(basecall_group_path(gr));
+        for (unsigned st = 0; st < 3; ++st)
+        {
+            bc_desc.have_subgroup[st] =
+                have_child(sg_l, basecall_strand_group_path(gr, st), hdf5_tools::H5O_TYPE_GROUP);
+            if (bc_desc.have_subgroup[st])
+            {
+                auto st_sg_l = Base::list_group_types(basecall_strand_group_path(gr, st));
+                // fastq
+                bc_desc.have_fastq[st] =
+                    have_child(st_sg_l, basecall_fastq_path(gr, st), hdf5_tools::H5O_TYPE_DATASET) or
+                    have_child(st_sg_l, basecall_fastq_pack_path(gr, st), hdf5_tools::H5O_TYPE_GROUP);
+                // events
+                bc_desc.have_events[st] =
+                    have_child(st_sg_l, basecall_events_path(gr, st), hdf5_tools::H5O_TYPE_DATASET) or
+                    have_child(st_sg_l, basecall_events_pack_path(gr, st), hdf5_tools::H5O_TYPE_GROUP);
+                if (st == 0)
                 {
-                    _basecall_strand_groups[st].push_back(gr);
-                    // fastq
-                    bc_desc.have_fastq[st] =
-                        have_basecall_fastq_unpack(st, gr) or
-                        have_basecall_fastq_pack(st, gr);
-                    // events
-                    bc_desc.have_events[st] =
-                        have_basecall_events_unpack(st, gr) or
-                        have_basecall_events_pack(st, gr);
-                    if (st == 0)
-                    {
-                        // ed_gr
-                        bc_desc.ed_gr = detect_basecall_eventdetection_group(gr);
-                    }
-                    if (st == 2)
-                    {
-                        // alignment
-                        bc_desc.have_alignment =
-                            have_basecall_alignment_unpack(gr)
-                            or have_basecall_alignment_pack(gr);
-                    }
+                    // ed_gr
+                    bc_desc.ed_gr = detect_basecall_eventdetection_group(gr);
+                }
+                if (st == 2)
+                {
+                    // alignment
+                    bc_desc.have_alignment =
+                        have_child(st_sg_l, basecall_alignment_path(gr), hdf5_tools::H5O_TYPE_DATASET)
+                        or have_child(st_sg_l, basecall_alignment_pack_path(gr), hdf5_tools::H5O_TYPE_GROUP);
                 }
             }
-            // bc_1d_gr
-            if (bc_desc.have_subgroup[0] or bc_desc.have_subgroup[1])
+        }
+        // bc_1d_gr
+        if (bc_desc.have_subgroup[0] or bc_desc.have_subgroup[1])
+        {
+            bc_desc.bc_1d_gr = gr;
+        }
+        else if (bc_desc.have_subgroup[2])
+        {
+            bc_desc.bc_1d_gr = detect_basecall_1d_group(gr);
+        }
+        // model
+        for (unsigned st = 0; st < 2; ++st)
+        {
+            bc_desc.have_model[st] =
+                not bc_desc.bc_1d_gr.empty()
+                and Base::dataset_exists(basecall_model_path(bc_desc.bc_1d_gr, st));
+        }
+        _basecall_group_descriptions[gr] = std::move(bc_desc);
+    }
+    void
+    load_basecall_strand_groups() const
+    {
+        for (unsigned st = 0; st < 3; ++st)
+        {
+            _basecall_strand_groups[st].clear();
+            for (auto const & gr : _basecall_groups.list())
             {
-                bc_desc.bc_1d_gr = gr;
+                if (_basecall_group_descriptions.at(gr).have_subgroup[st])
+                {
+                    _basecall_strand_groups[st].insert(gr);
+                }
             }
-            else if (bc_desc.have_subgroup[2])
+        }
+    }
+
+    //
+    // Incremental cache updaters, run after writing a dataset: they touch only the entries
+    // the new dataset can affect, instead of reloading the whole file structure.
+    //
+    void
+    update_raw_samples_read_name(std::string const & rn)
+    {
+        raw_samples_read_names();
+        _raw_samples_read_names.insert(is_read_view()? _read_id : rn);
+    }
+    void
+    update_eventdetection_read_name(std::string const & gr, std::string const & rn)
+    {
+        ensure_eventdetection_groups();
+        if (not _eventdetection_read_names.count(gr))
+        {
+            _eventdetection_groups.insert(gr);
+            _eventdetection_read_names[gr];
+            // a new eventdetection group can be the one a basecall group refers to
+            for (auto & p : _basecall_group_descriptions)
             {
-                bc_desc.bc_1d_gr = detect_basecall_1d_group(gr);
+                if (p.second.have_subgroup[0] and p.second.ed_gr.empty())
+                {
+                    p.second.ed_gr = detect_basecall_eventdetection_group(p.first);
+                }
             }
-            // model
-            for (unsigned st = 0; st < 2; ++st)
+        }
+        _eventdetection_read_names.at(gr).insert(rn);
+    }
+    void
+    update_basecall_group(std::string const & gr)
+    {
+        ensure_basecall_groups();
+        bool is_new = not have_basecall_group(gr);
+        if (is_new) _basecall_groups.insert(gr);
+        load_basecall_group(gr);
+        // other groups depending on this one: those using it as their 1d group, and,
+        // if it is new, 2D-only groups whose 1d group was not found
+        for (auto const & gr2 : _basecall_groups.list())
+        {
+            if (gr2 == gr) continue;
+            auto const & bc_desc = _basecall_group_descriptions.at(gr2);
+            if (bc_desc.bc_1d_gr == gr
+                or (is_new and bc_desc.bc_1d_gr == gr2
+                    and not bc_desc.have_subgroup[0] and not bc_desc.have_subgroup[1]))
             {
-                bc_desc.have_model[st] =
-                    not bc_desc.bc_1d_gr.empty()
-                    and Base::dataset_exists(basecall_model_path(bc_desc.bc_1d_gr, st));
+                load_basecall_group(gr2);
             }
         }
+        load_basecall_strand_groups();
+    }
+    // check if a group listing contains the object at the given path, with the given type
+    template < typename Group_Type_List, typename Type >
+    static bool
+    have_child(Group_Type_List const & l, std::string const & path, Type type)
+    {
+        auto name = path.substr(path.rfind('/') + 1);
+        return std::find(l.begin(), l.end(), typename Group_Type_List::value_type(name, type)) != l.end();
     }
     Basecall_Group_Description
     detect_basecall_group_id(std::string const & gr) const
@@ -1598,7 +2316,8 @@ private:
         if (bc_params.count("event_detection"))
         {
             auto && tmp = bc_params.at("event_detection");
-            auto pref = eventdetection_root_path().substr(1) + "/" + eventdetection_group_prefix();
+            // path relative to the read root, as written by basecallers
+            auto pref = eventdetection_root_path().substr(root_path().size() + 1) + "/" + eventdetection_group_prefix();
             if (tmp.substr(0, pref.size()) == pref)
             {
                 auto ed_gr = tmp.substr(pref.size());
@@ -1639,33 +2358,31 @@ private:
     std::string const &
     fill_raw_samples_read_name(std::string const & rn) const
     {
-        return (not rn.empty() or _raw_samples_read_names.empty()
+        return (not rn.empty() or raw_samples_read_names().empty()
                 ? rn
-                : _raw_samples_read_names.front());
+                : raw_samples_read_names().front());
     }
     std::string const &
     fill_eventdetection_group(std::string const & gr) const
     {
-        return (not gr.empty() or _eventdetection_groups.empty()
+        return (not gr.empty() or eventdetection_groups().empty()
                 ? gr
-                : _eventdetection_groups.front());
+                : eventdetection_groups().front());
     }
     std::string const &
     fill_eventdetection_read_name(std::string const & gr, std::string const & rn) const
     {
-        return (not rn.empty()
-                or _eventdetection_read_names.count(gr) == 0
-                or _eventdetection_read_names.at(gr).empty()
-                ? rn
-                : _eventdetection_read_names.at(gr).front());
+        if (not rn.empty()) return rn;
+        auto rn_l_ptr = eventdetection_read_name_list_ptr(gr);
+        return rn_l_ptr and not rn_l_ptr->empty()? rn_l_ptr->front() : rn;
     }
     std::string const &
     fill_basecall_group(unsigned st, std::string const & gr) const
     {
         return (not gr.empty()
-                or _basecall_strand_groups.at(st).empty()
+                or basecall_strand_groups().at(st).empty()
                 ? gr
-                : _basecall_strand_groups.at(st).front());
+                : basecall_strand_groups().at(st).front());
     }
     std::string const &
     fill_basecall_1d_group(unsigned st, std::string const & gr) const
@@ -1690,7 +2407,7 @@ private:
     {
         auto path = raw_samples_pack_path(rn);
         rs_pack.write(*this, path);
-        reload();
+        update_raw_samples_read_name(rn);
     }
     Raw_Int_Samples_Dataset
     get_raw_int_samples_dataset(std::string const & rn = std::string()) const
@@ -1730,7 +2447,7 @@ private:
         EventDetection_Events_Pack const & ede_pack)
     {
         ede_pack.write(*this, eventdetection_events_pack_path(gr, rn));
-        reload();
+        update_eventdetection_read_name(gr, rn);
     }
     EventDetection_Events_Dataset
     get_eventdetection_events_dataset(
@@ -1763,7 +2480,7 @@ private:
     {
         auto p = basecall_fastq_pack_path(gr, st);
         fq_pack.write(*this, p);
-        reload();
+        update_basecall_group(gr);
     }
     //
     Basecall_Events_Pack
@@ -1779,7 +2496,7 @@ private:
     {
         auto p = basecall_events_pack_path(gr, st);
         ev_pack.write(*this, p);
-        reload();
+        update_basecall_group(gr);
     }
     Basecall_Events_Dataset
     get_basecall_events_dataset(unsigned st, std::string const & gr) const
@@ -1809,7 +2526,7 @@ private:
     {
         auto p = basecall_alignment_pack_path(gr);
         al_pack.write(*this, p);
-        reload();
+        update_basecall_group(gr);
     }
 
     //
@@ -1967,11 +2684,10 @@ private:
             [&] (unsigned i, long long x) { return ede.at(i).length = x; },
             ede_params.start_time);
         int offset = 0;
-        static bool warned = false;
-        if (offset != 0 and not warned)
+        static std::atomic< bool > warned(false);
+        if (offset != 0 and not warned.exchange(true))
         {
             LOG(warning) << "using workaround for old off-by-one ed events bug\n";
-            warned = true;
         }
         unpack_event_mean_stdv(
             ede.size(),
@@ -2010,15 +2726,20 @@ private:
     }
     static std::string
     unpack_fq(Basecall_Fastq_Pack const & fq_pack)
+    {
+        auto bp = fq_bp_coder().decode< std::int8_t >(fq_pack.bp, fq_pack.bp_params);
+        auto qv = fq_qv_coder().decode< std::uint8_t >(fq_pack.qv, fq_pack.qv_params);
+        return make_fq(fq_pack.read_name, bp, qv);
+    }
+    static std::string
+    make_fq(std::string const & read_name, std::vector< std::int8_t > const & bp, std::vector< std::uint8_t > const & qv)
     {
         std::string res;
         res += "@";
-        res += fq_pack.read_name;
+        res += read_name;
         res += "\n";
-        auto bp = fq_bp_coder().decode< std::int8_t >(fq_pack.bp, fq_pack.bp_params);
         for (auto c : bp) res += c;
         res += "\n+\n";
-        auto qv = fq_qv_coder().decode< std::uint8_t >(fq_pack.qv, fq_pack.qv_params);
         for (auto c : qv) res += (char)33 + c;
         res += "\n";
         return res;
@@ -2175,12 +2896,11 @@ private:
             [&] (unsigned i, long long x) { return ede.at(i).length = x; },
             ev_pack.start_time);
         int offset = 0;
-        static bool warned = false;
-        if (offset != 0 and not warned)
+        static std::atomic< bool > warned(false);
+        if (offset != 0 and not warned.exchange(true))
         {
             LOG(warning) << "using workaround for bug in "
                          << ev_pack.name << ":" << ev_pack.version << "\n";
-            warned = true;
         }
         unpack_event_mean_stdv(
             ede.size(),
@@ -2374,50 +3094,67 @@ private:
     //
     // Fast5 internal paths
     //
+    // In a read view, paths are under the read group, and raw samples paths ignore the read name.
     static std::string file_version_path() { return "/file_version"; }
-    static std::string channel_id_path()   { return "/UniqueGlobalKey/channel_id"; }
-    static std::string tracking_id_path()  { return "/UniqueGlobalKey/tracking_id"; }
-    static std::string sequences_path()    { return "/Sequences/Meta"; }
-    static std::string raw_samples_root_path() { return "/Raw/Reads"; }
-    static std::string raw_samples_params_path(std::string const & rn)
+    static std::string read_group_prefix() { return "read_"; }
+    static std::string read_group_path(std::string const & read_id)
+    {
+        return "/" + read_group_prefix() + read_id;
+    }
+    std::string root_path() const
+    {
+        return is_read_view()? read_group_path(_read_id) : std::string();
+    }
+    std::string unique_global_key_path() const
+    {
+        return is_read_view()? root_path() : std::string("/UniqueGlobalKey");
+    }
+    std::string channel_id_path() const  { return unique_global_key_path() + "/channel_id"; }
+    std::string tracking_id_path() const { return unique_global_key_path() + "/tracking_id"; }
+    std::string sequences_path() const   { return root_path() + "/Sequences/Meta"; }
+    std::string raw_samples_root_path() const
+    {
+        return is_read_view()? root_path() : std::string("/Raw/Reads");
+    }
+    std::string raw_samples_params_path(std::string const & rn) const
     {
-        return raw_samples_root_path() + "/" + rn;
+        return raw_samples_root_path() + "/" + (is_read_view()? std::string("Raw") : rn);
     }
-    static std::string raw_samples_path(std::string const & rn)
+    std::string raw_samples_path(std::string const & rn) const
     {
-        return raw_samples_root_path() + "/" + rn + "/Signal";
+        return raw_samples_params_path(rn) + "/Signal";
     }
-    static std::string raw_samples_pack_path(std::string const & rn)
+    std::string raw_samples_pack_path(std::string const & rn) const
     {
         return raw_samples_path(rn) + "_Pack";
     }
-    static std::string raw_samples_params_pack_path(std::string const & rn)
+    std::string raw_samples_params_pack_path(std::string const & rn) const
     {
         return raw_samples_pack_path(rn) + "/params";
     }
-    static std::string eventdetection_root_path() { return "/Analyses"; }
+    std::string eventdetection_root_path() const { return root_path() + "/Analyses"; }
     static std::string eventdetection_group_prefix() { return "EventDetection_"; }
-    static std::string eventdetection_group_path(std::string const & gr)
+    std::string eventdetection_group_path(std::string const & gr) const
     {
         return eventdetection_root_path() + "/" + eventdetection_group_prefix() + gr;
     }
-    static std::string eventdetection_events_params_path(std::string const & gr, std::string const & rn)
+    std::string eventdetection_events_params_path(std::string const & gr, std::string const & rn) const
     {
         return eventdetection_group_path(gr) + "/Reads/" + rn;
     }
-    static std::string eventdetection_events_path(std::string const & gr, std::string const & rn)
+    std::string eventdetection_events_path(std::string const & gr, std::string const & rn) const
     {
         return eventdetection_group_path(gr) + "/Reads/" + rn + "/Events";
     }
-    static std::string eventdetection_events_pack_path(std::string const & gr, std::string const & rn)
+    std::string eventdetection_events_pack_path(std::string const & gr, std::string const & rn) const
     {
         return eventdetection_events_path(gr, rn) + "_Pack";
     }
-    static std::string eventdetection_events_params_pack_path(std::string const & gr, std::string const & rn)
+    std::string eventdetection_events_params_pack_path(std::string const & gr, std::string const & rn) const
     {
         return eventdetection_events_pack_path(gr, rn) + "/params";
     }
-    static std::string basecall_root_path() { return "/Analyses"; }
+    std::string basecall_root_path() const { return root_path() + "/Analyses"; }
     static std::string basecall_group_prefix() { return "Basecall_"; }
     static std::string strand_name(unsigned st)
     {
@@ -2429,59 +3166,59 @@ private:
     {
         return std::string("BaseCalled_") + strand_name(st);
     }
-    static std::string basecall_group_path(std::string const & gr)
+    std::string basecall_group_path(std::string const & gr) const
     {
         return basecall_root_path() + "/" + basecall_group_prefix() + gr;
     }
-    static std::string basecall_strand_group_path(std::string const & gr, unsigned st)
+    std::string basecall_strand_group_path(std::string const & gr, unsigned st) const
     {
         return basecall_group_path(gr) + "/" + basecall_strand_subgroup(st);
     }
-    static std::string basecall_log_path(std::string const & gr)
+    std::string basecall_log_path(std::string const & gr) const
     {
         return basecall_group_path(gr) + "/Log";
     }
-    static std::string basecall_fastq_path(std::string const & gr, unsigned st)
+    std::string basecall_fastq_path(std::string const & gr, unsigned st) const
     {
         return basecall_strand_group_path(gr, st) + "/Fastq";
     }
-    static std::string basecall_fastq_pack_path(std::string const & gr, unsigned st)
+    std::string basecall_fastq_pack_path(std::string const & gr, unsigned st) const
     {
         return basecall_fastq_path(gr, st) + "_Pack";
     }
-    static std::string basecall_model_path(std::string const & gr, unsigned st)
+    std::string basecall_model_path(std::string const & gr, unsigned st) const
     {
         return basecall_strand_group_path(gr, st) + "/Model";
     }
-    static std::string basecall_model_file_path(std::string const & gr, unsigned st)
+    std::string basecall_model_file_path(std::string const & gr, unsigned st) const
     {
         return basecall_group_path(gr) + "/Summary/basecall_1d_" + strand_name(st) + "/model_file";
     }
-    static std::string basecall_events_path(std::string const & gr, unsigned st)
+    std::string basecall_events_path(std::string const & gr, unsigned st) const
     {
         return basecall_strand_group_path(gr, st) + "/Events";
     }
-    static std::string basecall_events_pack_path(std::string const & gr, unsigned st)
+    std::string basecall_events_pack_path(std::string const & gr, unsigned st) const
     {
         return basecall_events_path(gr, st) + "_Pack";
     }
-    static std::string basecall_events_params_pack_path(std::string const & gr, unsigned st)
+    std::string basecall_events_params_pack_path(std::string const & gr, unsigned st) const
     {
         return basecall_events_pack_path(gr, st) + "/params";
     }
-    static std::string basecall_alignment_path(std::string const & gr)
+    std::string basecall_alignment_path(std::string const & gr) const
     {
         return basecall_strand_group_path(gr, 2) + "/Alignment";
     }
-    static std::string basecall_alignment_pack_path(std::string const & gr)
+    std::string basecall_alignment_pack_path(std::string const & gr) const
     {
         return basecall_alignment_path(gr) + "_Pack";
     }
-    static std::string basecall_config_path(std::string const & gr)
+    std::string basecall_config_path(std::string const & gr) const
     {
         return basecall_group_path(gr) + "/Configuration";
     }
-    static std::string basecall_summary_path(std::string const & gr)
+    std::string basecall_summary_path(std::string const & gr) const
     {
         return basecall_group_path(gr) + "/Summary";
     }
@@ -8,11 +8,19 @@
 #ifndef __HDF5_TOOLS_HPP
 #define __HDF5_TOOLS_HPP
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <exception>
 #include <functional>
 #include <fstream>
+#include <initializer_list>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -23,6 +31,8 @@
 #include <map>
 #include <queue>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <type_traits>
 
 /// Original HDF5 C API.
@@ -60,6 +70,27 @@ private:
     std::string _msg;
 }; // class Exception
 
+/**
+ * Byte counters of HDF5 dataset and attribute transfers.
+ * Sizes are those of the file datatypes; counters are kept per thread, so the difference
+ * of two snapshots measures the I/O done by the calling thread in between.
+ */
+struct IO_Counts
+{
+    /// Bytes read
+    size_t read_bytes;
+    /// Bytes written
+    size_t write_bytes;
+
+    IO_Counts() : read_bytes(0), write_bytes(0) {}
+    /// Counters of the calling thread.
+    static IO_Counts & thread_counts()
+    {
+        static thread_local IO_Counts _counts;
+        return _counts;
+    }
+}; // struct IO_Counts
+
 // Forward declaration
 class Compound_Map;
 
@@ -163,43 +194,364 @@ struct mem_type_class<std::string>
 };
 #endif
 
+/**
+ * Library lock.
+ * Concurrency model: one File object per thread; HDF5 calls are serialized behind a library mutex;
+ * everything else (e.g. decoding, encoding) runs in parallel.
+ * With a thread-safe HDF5 build, the HDF5 library itself serializes API calls, and this lock is a no-op.
+ * Otherwise, every HDF5 call made by hdf5_tools holds the recursive mutex returned by @p mutex().
+ */
+class Library_Lock
+{
+public:
+    static std::recursive_mutex & mutex()
+    {
+        static std::recursive_mutex _mutex;
+        return _mutex;
+    }
+#ifdef H5_HAVE_THREADSAFE
+    Library_Lock() {}
+#else
+    Library_Lock() : _lock(mutex()) {}
+private:
+    std::lock_guard< std::recursive_mutex > _lock;
+#endif
+}; // class Library_Lock
+
+/**
+ * Check of HDF5 API return values, selected statically by return type.
+ * @em Default: status values (herr_t, htri_t, int) are valid iff nonnegative.
+ */
+template <typename Return_Type>
+struct Return_Check
+{
+    static bool valid(Return_Type v) { return v >= 0; }
+};
+#ifndef DOXY
+/// Object ids (hid_t) are valid iff positive. Note: on LP64, this also applies to ssize_t.
+template <>
+struct Return_Check<hid_t>
+{
+    static bool valid(hid_t v) { return v > 0; }
+};
+/// Sizes are valid iff positive.
+template <>
+struct Return_Check<size_t>
+{
+    static bool valid(size_t v) { return v > 0; }
+};
+template <>
+struct Return_Check<char *>
+{
+    static bool valid(char * v) { return v != nullptr; }
+};
+template <>
+struct Return_Check<H5S_class_t>
+{
+    static bool valid(H5S_class_t v) { return v != H5S_NO_CLASS; }
+};
+template <>
+struct Return_Check<H5T_class_t>
+{
+    static bool valid(H5T_class_t v) { return v != H5T_NO_CLASS; }
+};
+template <>
+struct Return_Check<H5T_cset_t>
+{
+    static bool valid(H5T_cset_t v) { return v != H5T_CSET_ERROR; }
+};
+template <>
+struct Return_Check<H5T_sign_t>
+{
+    static bool valid(H5T_sign_t v) { return v != H5T_SGN_ERROR; }
+};
+#endif
+
+/**
+ * Get name of HDF5 function.
+ * Only used to build error messages and profiling reports, so it is never on the fast path.
+ */
+inline char const *
+get_fcn_name(void (*fcn_ptr)())
+{
+    static std::map<void (*)(), char const *> const fcn_name_m =
+        {
+            { (void(*)())&H5Aclose, "H5Aclose" },
+            { (void(*)())&H5Acreate2, "H5Acreate2" },
+            { (void(*)())&H5Aexists_by_name, "H5Aexists_by_name" },
+            { (void(*)())&H5Aget_name_by_idx, "H5Aget_name_by_idx" },
+            { (void(*)())&H5Aget_space, "H5Aget_space" },
+            { (void(*)())&H5Aget_type, "H5Aget_type" },
+            { (void(*)())&H5Aopen, "H5Aopen" },
+            { (void(*)())&H5Aopen_by_name, "H5Aopen_by_name" },
+            { (void(*)())&H5Aread, "H5Aread" },
+            { (void(*)())&H5Awrite, "H5Awrite" },
+
+            { (void(*)())&H5Dclose, "H5Dclose" },
+            { (void(*)())&H5Dcreate2, "H5Dcreate2" },
+            { (void(*)())&H5Dget_space, "H5Dget_space" },
+            { (void(*)())&H5Dget_type, "H5Dget_type" },
+            { (void(*)())&H5Dopen, "H5Dopen" },
+            { (void(*)())&H5Dread, "H5Dread" },
+            { (void(*)())&H5Dset_extent, "H5Dset_extent" },
+            { (void(*)())&H5Dvlen_reclaim, "H5Dvlen_reclaim" },
+            { (void(*)())&H5Dwrite, "H5Dwrite" },
+
+            { (void(*)())&H5Fflush, "H5Fflush" },
+            { (void(*)())&H5Fget_file_image, "H5Fget_file_image" },
+            { (void(*)())&H5Fstart_swmr_write, "H5Fstart_swmr_write" },
+
+            { (void(*)())&H5Gclose, "H5Gclose" },
+            { (void(*)())&H5Gcreate2, "H5Gcreate2" },
+            { (void(*)())&H5Gget_info, "H5Gget_info" },
+            { (void(*)())&H5Gopen2, "H5Gopen2" },
+
+            { (void(*)())&H5Ldelete, "H5Ldelete" },
+            { (void(*)())&H5Lexists, "H5Lexists" },
+            { (void(*)())&H5Lget_name_by_idx, "H5Lget_name_by_idx" },
+            { (void(*)())&H5Lvisit, "H5Lvisit" },
+
+            { (void(*)())&H5Oclose, "H5Oclose" },
+            { (void(*)())&H5Oexists_by_name, "H5Oexists_by_name" },
+            { (void(*)())&H5Oget_info, "H5Oget_info" },
+            { (void(*)())&H5Oget_info_by_name, "H5Oget_info_by_name" },
+            { (void(*)())&H5Ovisit2, "H5Ovisit2" },
+            { (void(*)())&H5Oopen, "H5Oopen" },
+            { (void(*)())&H5Orefresh, "H5Orefresh" },
+
+            { (void(*)())&H5Pclose, "H5Pclose" },
+            { (void(*)())&H5Pcreate, "H5Pcreate" },
+            { (void(*)())&H5Pset_chunk, "H5Pset_chunk" },
+            { (void(*)())&H5Pset_fapl_core, "H5Pset_fapl_core" },
+            { (void(*)())&H5Pset_file_image, "H5Pset_file_image" },
+            { (void(*)())&H5Pset_create_intermediate_group, "H5Pset_create_intermediate_group" },
+            { (void(*)())&H5Pset_libver_bounds, "H5Pset_libver_bounds" },
+
+            { (void(*)())&H5Sclose, "H5Sclose" },
+            { (void(*)())&H5Screate, "H5Screate" },
+            { (void(*)())&H5Screate_simple, "H5Screate_simple" },
+            { (void(*)())&H5Sget_simple_extent_dims, "H5Sget_simple_extent_dims" },
+            { (void(*)())&H5Sget_simple_extent_ndims, "H5Sget_simple_extent_ndims" },
+            { (void(*)())&H5Sget_simple_extent_type, "H5Sget_simple_extent_type" },
+            { (void(*)())&H5Sget_simple_extent_npoints, "H5Sget_simple_extent_npoints" },
+            { (void(*)())&H5Sselect_hyperslab, "H5Sselect_hyperslab" },
+
+            { (void(*)())&H5Tclose, "H5Tclose" },
+            { (void(*)())&H5Tcopy, "H5Tcopy" },
+            { (void(*)())&H5Tcreate, "H5Tcreate" },
+            { (void(*)())&H5Tget_class, "H5Tget_class" },
+            { (void(*)())&H5Tget_cset, "H5Tget_cset" },
+            { (void(*)())&H5Tget_member_index, "H5Tget_member_index" },
+            { (void(*)())&H5Tget_member_name, "H5Tget_member_name" },
+            { (void(*)())&H5Tget_member_type, "H5Tget_member_type" },
+            { (void(*)())&H5Tget_nmembers, "H5Tget_nmembers" },
+            { (void(*)())&H5Tget_sign, "H5Tget_sign" },
+            { (void(*)())&H5Tget_size, "H5Tget_size" },
+            { (void(*)())&H5Tinsert, "H5Tinsert" },
+            { (void(*)())&H5Tis_variable_str, "H5Tis_variable_str" },
+            { (void(*)())&H5Tset_cset, "H5Tset_cset" },
+            { (void(*)())&H5Tset_size, "H5Tset_size" },
+        };
+    auto it = fcn_name_m.find(fcn_ptr);
+    return it != fcn_name_m.end()? it->second : "HDF5 call";
+} // get_fcn_name()
+
+/**
+ * Profiler of HDF5 calls.
+ * When enabled, records the number of calls and the cumulative time of each HDF5 function
+ * called through @p Util::wrap or as an object closer, both per function and per prefix of
+ * the active HDF5 path (see @p Exception::active_path()).
+ * Disabled by default, when its cost is one atomic load per call. If the environment variable
+ * HDF5_TOOLS_PROFILE is set, it is enabled at startup and a report is printed to stderr at exit.
+ */
+class Profiler
+{
+public:
+    typedef std::chrono::steady_clock clock_type;
+    /// Counters of one function or path prefix
+    struct Entry
+    {
+        size_t calls;
+        double time;
+
+        Entry() : calls(0), time(0.0) {}
+    };
+    /// Profile: counters by function name and by path prefix
+    struct Profile
+    {
+        std::map< std::string, Entry > fcn_m;
+        std::map< std::string, Entry > path_m;
+    };
+
+    /// Times one HDF5 call, if profiling is enabled.
+    class Call_Timer
+    {
+    public:
+        explicit Call_Timer(void (*fcn_ptr)())
+            : _fcn_ptr(enabled()? fcn_ptr : nullptr)
+        {
+            if (_fcn_ptr) _start = clock_type::now();
+        }
+        Call_Timer(Call_Timer const &) = delete;
+        Call_Timer & operator = (Call_Timer const &) = delete;
+        ~Call_Timer()
+        {
+            if (_fcn_ptr) record(_fcn_ptr, std::chrono::duration< double >(clock_type::now() - _start).count());
+        }
+    private:
+        void (*_fcn_ptr)();
+        clock_type::time_point _start;
+    }; // class Call_Timer
+
+    static bool enabled() { return flag().load(std::memory_order_relaxed); }
+    /**
+     * Enable or disable profiling.
+     * @param enable Flag.
+     * @param prefix_depth Number of path components of the path prefixes used in the report.
+     */
+    static void enable(bool enable, unsigned prefix_depth = 3)
+    {
+        {
+            std::lock_guard< std::mutex > lock(data().mutex);
+            data().prefix_depth = prefix_depth;
+        }
+        flag() = enable;
+    }
+    /// Get the current profile.
+    static Profile get()
+    {
+        Profile res;
+        std::lock_guard< std::mutex > lock(data().mutex);
+        for (auto const & p : data().fcn_m)
+        {
+            auto & e = res.fcn_m[get_fcn_name(p.first)];
+            e.calls += p.second.calls;
+            e.time += p.second.time;
+        }
+        res.path_m = data().path_m;
+        return res;
+    }
+    /// Clear all counters.
+    static void reset()
+    {
+        std::lock_guard< std::mutex > lock(data().mutex);
+        data().fcn_m.clear();
+        data().path_m.clear();
+    }
+    /// Print the current profile, sorted by decreasing cumulative time.
+    static void print(std::ostream & os)
+    {
+        auto prof = get();
+        auto print_section = [&os] (std::string const & title, std::map< std::string, Entry > const & m) {
+            std::vector< std::pair< std::string, Entry > > v(m.begin(), m.end());
+            std::sort(v.begin(), v.end(), [] (std::pair< std::string, Entry > const & lhs,
+                                              std::pair< std::string, Entry > const & rhs) {
+                          return lhs.second.time > rhs.second.time;
+                      });
+            os << title << "\tcalls\ttime\n";
+            for (auto const & p : v)
+            {
+                os << p.first << "\t" << p.second.calls << "\t"
+                   << std::fixed << std::setprecision(6) << p.second.time << "\n";
+            }
+        };
+        print_section("hdf5_function", prof.fcn_m);
+        print_section("hdf5_path_prefix", prof.path_m);
+    }
+private:
+    struct Data
+    {
+        std::mutex mutex;
+        unsigned prefix_depth;
+        std::map< void (*)(), Entry > fcn_m;
+        std::map< std::string, Entry > path_m;
+
+        Data() : prefix_depth(3) {}
+    };
+    static Data & data()
+    {
+        static Data _data;
+        return _data;
+    }
+    static std::atomic< bool > & flag()
+    {
+        static std::atomic< bool > _flag([] () {
+                if (not std::getenv("HDF5_TOOLS_PROFILE")) return false;
+                // construct data first, so that it outlives the exit handler
+                data();
+                std::atexit([] () { print(std::cerr); });
+                return true;
+            }());
+        return _flag;
+    }
+    static void record(void (*fcn_ptr)(), double time)
+    {
+        auto const & path = Exception::active_path();
+        std::lock_guard< std::mutex > lock(data().mutex);
+        // path prefix: first prefix_depth components
+        size_t pos = 0;
+        for (unsigned i = 0; i < data().prefix_depth and pos != std::string::npos; ++i)
+        {
+            pos = path.find('/', pos + 1);
+        }
+        auto & fcn_e = data().fcn_m[fcn_ptr];
+        ++fcn_e.calls;
+        fcn_e.time += time;
+        auto & path_e = data().path_m[path.substr(0, pos)];
+        ++path_e.calls;
+        path_e.time += time;
+    }
+}; // class Profiler
+
 /**
  * HDF5 object holder.
  * Upon destruction, deallocate the held HDF5 object, check the HDF5 API return value, and throw exception on error.
  */
 struct HDF_Object_Holder
 {
+    /// HDF5 object deallocator type
+    typedef herr_t (*closer_type)(hid_t);
     /// HDF5 object
     hid_t id;
     /// HDF5 object deallocator
-    std::function<herr_t(hid_t)> dtor;
+    closer_type dtor;
 
     /// Ctor: default
     HDF_Object_Holder()
-        : id(0) {}
+        : id(0), dtor(nullptr) {}
     /// Ctor: copy
     HDF_Object_Holder(HDF_Object_Holder const &) = delete;
     /// Ctor: move
     HDF_Object_Holder(HDF_Object_Holder && other)
-        : id(0)
+        : id(0), dtor(nullptr)
     {
         *this = std::move(other);
     }
     /// Ctor: from HDF5 object and destructor
-    HDF_Object_Holder(hid_t _id, std::function<herr_t(hid_t)> _dtor)
+    HDF_Object_Holder(hid_t _id, closer_type _dtor)
         : id(_id), dtor(_dtor) {}
     /// Dtor: throw on HDF5 errors
     ~HDF_Object_Holder() noexcept(false)
     {
         if (id > 0)
         {
-            if (dtor)
+            Library_Lock lock;
+            herr_t status;
             {
-                dtor(id);
+                Profiler::Call_Timer timer((void(*)())dtor);
+                status = dtor? dtor(id) : 0;
             }
             id = 0;
+            if (status < 0) throw Exception(std::string("error in ") + get_fcn_name((void(*)())dtor));
         }
     }
+    /// Release ownership of the held HDF5 object, and return it.
+    hid_t release()
+    {
+        hid_t res = id;
+        id = 0;
+        return res;
+    }
     /// Asop: copy
     HDF_Object_Holder & operator = (HDF_Object_Holder const &) = delete;
     /// Asop: move
@@ -246,304 +598,22 @@ struct Util
     static typename std::result_of<Function(Args...)>::type
     wrap(Function && f, Args && ...args)
     {
+        Library_Lock lock;
+        Profiler::Call_Timer timer((void(*)())&f);
         auto res = f(args...);
-        auto const & f_info = get_fcn_info((void(*)())&f);
-        if (not f_info.second((void*)&res)) throw Exception(std::string("error in ") + f_info.first);
+        if (not Return_Check<decltype(res)>::valid(res)) throw Exception(std::string("error in ") + get_fcn_name((void(*)())&f));
         return res;
     }
 
     /**
      * Wrapped closer function.
-     * Create and return a wrapped closer function.
-     * @tparam Function HDF5 closer function type.
+     * Return a closer function for @p HDF_Object_Holder, which checks its return value.
      * @param f HDF5 closer function.
      */
-    template <typename Function>
-    static std::function<herr_t(hid_t)>
-    wrapped_closer(Function && f)
-    {
-        return [&] (hid_t id) { return wrap(f, id); };
-    }
-
-private:
-    /**
-     * Get name and return value checker for HDF5 function.
-     * Maintain a static map of HDF5 functions and corresponding checks for return value validity.
-     */
-    static std::pair<char const *, std::function<bool(void *)>> const &
-    get_fcn_info(void (*fcn_ptr)())
+    static HDF_Object_Holder::closer_type
+    wrapped_closer(HDF_Object_Holder::closer_type f)
     {
-        static std::map<void (*)(), std::pair<char const *, std::function<bool(void *)>>> const fcn_info_m =
-            {
-                { (void(*)())&H5Aclose,
-                  { "H5Aclose",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Acreate2,
-                  { "H5Acreate2",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Aexists_by_name,
-                  { "H5Aexists_by_name",
-                    [] (void * vp) { return *reinterpret_cast<htri_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Aget_name_by_idx,
-                  { "H5Aget_name_by_idx",
-                    [] (void * vp) { return *reinterpret_cast<ssize_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Aget_space,
-                  { "H5Aget_space",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Aget_type,
-                  { "H5Aget_type",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Aopen,
-                  { "H5Aopen",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Aopen_by_name,
-                  { "H5Aopen_by_name",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Aread,
-                  { "H5Aread",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Awrite,
-                  { "H5Awrite",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-
-                { (void(*)())&H5Dclose,
-                  { "H5Dclose",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Dcreate2,
-                  { "H5Dcreate2",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Dget_space,
-                  { "H5Dget_space",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Dget_type,
-                  { "H5Dget_type",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Dopen,
-                  { "H5Dopen",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Dread,
-                  { "H5Dread",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Dvlen_reclaim,
-                  { "H5Dvlen_reclaim",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Dwrite,
-                  { "H5Dwrite",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-
-                { (void(*)())&H5Gclose,
-                  { "H5Gclose",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Gcreate2,
-                  { "H5Gcreate2",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Gget_info,
-                  { "H5Gget_info",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Gopen2,
-                  { "H5Gopen2",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-
-                { (void(*)())&H5Lexists,
-                  { "H5Lexists",
-                    [] (void * vp) { return *reinterpret_cast<htri_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Lget_name_by_idx,
-                  { "H5Lget_name_by_idx",
-                    [] (void * vp) { return *reinterpret_cast<ssize_t *>(vp) >= 0; }
-                  }
-                },
-
-                { (void(*)())&H5Oclose,
-                  { "H5Oclose",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Oexists_by_name,
-                  { "H5Oexists_by_name",
-                    [] (void * vp) { return *reinterpret_cast<htri_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Oget_info,
-                  { "H5Oget_info",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Oopen,
-                  { "H5Oopen",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-
-                { (void(*)())&H5Pclose,
-                  { "H5Pclose",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Pcreate,
-                  { "H5Pcreate",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Pset_create_intermediate_group,
-                  { "H5Pset_create_intermediate_group",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-
-                { (void(*)())&H5Sclose,
-                  { "H5Sclose",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Screate,
-                  { "H5Screate",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Screate_simple,
-                  { "H5Screate_simple",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Sget_simple_extent_dims,
-                  { "H5Sget_simple_extent_dims",
-                    [] (void * vp) { return *reinterpret_cast<int *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Sget_simple_extent_ndims,
-                  { "H5Sget_simple_extent_ndims",
-                    [] (void * vp) { return *reinterpret_cast<int *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Sget_simple_extent_type,
-                  { "H5Sget_simple_extent_type",
-                    [] (void * vp) { return *reinterpret_cast<H5S_class_t *>(vp) != H5S_NO_CLASS; }
-                  }
-                },
-
-                { (void(*)())&H5Tclose,
-                  { "H5Tclose",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Tcopy,
-                  { "H5Tcopy",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Tcreate,
-                  { "H5Tcreate",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Tget_class,
-                  { "H5Tget_class",
-                    [] (void * vp) { return *reinterpret_cast<H5T_class_t *>(vp) != H5T_NO_CLASS; }
-                  }
-                },
-                { (void(*)())&H5Tget_cset,
-                  { "H5Tget_cset",
-                    [] (void * vp) { return *reinterpret_cast<H5T_cset_t *>(vp) != H5T_CSET_ERROR; }
-                  }
-                },
-                { (void(*)())&H5Tget_member_index,
-                  { "H5Tget_member_index",
-                    [] (void * vp) { return *reinterpret_cast<int *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Tget_member_name,
-                  { "H5Tget_member_name",
-                    [] (void * vp) { return *reinterpret_cast<char* *>(vp) != nullptr; }
-                  }
-                },
-                { (void(*)())&H5Tget_member_type,
-                  { "H5Tget_member_type",
-                    [] (void * vp) { return *reinterpret_cast<hid_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Tget_nmembers,
-                  { "H5Tget_nmembers",
-                    [] (void * vp) { return *reinterpret_cast<int *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Tget_sign,
-                  { "H5Tget_sign",
-                    [] (void * vp) { return *reinterpret_cast<H5T_sign_t *>(vp) != H5T_SGN_ERROR; }
-                  }
-                },
-                { (void(*)())&H5Tget_size,
-                  { "H5Tget_size",
-                    [] (void * vp) { return *reinterpret_cast<size_t *>(vp) > 0; }
-                  }
-                },
-                { (void(*)())&H5Tinsert,
-                  { "H5Tinsert",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Tis_variable_str,
-                  { "H5Tis_variable_str",
-                    [] (void * vp) { return *reinterpret_cast<htri_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Tset_cset,
-                  { "H5Tset_cset",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-                { (void(*)())&H5Tset_size,
-                  { "H5Tset_size",
-                    [] (void * vp) { return *reinterpret_cast<herr_t *>(vp) >= 0; }
-                  }
-                },
-            };
-        return fcn_info_m.at(fcn_ptr);
+        return f;
     }
 
 }; // struct Util
@@ -673,6 +743,48 @@ public:
     size_t compound_size;
 }; // struct Compound_Member_Description
 
+/**
+ * Cache of HDF5 types built from a compound map.
+ * Cached types stay open for the lifetime of the cache. Access is serialized by @p mutex.
+ * Lock order: @p Library_Lock first, then @p mutex.
+ */
+struct Compound_Type_Cache
+{
+    /// Cache key: compound size, fill flag, and selection flags of non-compound members.
+    typedef std::tuple<size_t, bool, std::vector<bool>> key_type;
+
+    /// Dtor: close cached types
+    ~Compound_Type_Cache() { clear(); }
+
+    /// Close and forget cached types.
+    void clear()
+    {
+        Library_Lock lock;
+        for (auto const & p : type_m)
+        {
+            if (p.second <= 0) continue;
+            // do not throw or report errors: this can run during static destruction
+            H5E_BEGIN_TRY {
+                H5Tclose(p.second);
+            } H5E_END_TRY;
+            --held_type_count();
+        }
+        type_m.clear();
+    }
+
+    /// Number of HDF5 types held open by all caches
+    static std::atomic<long> & held_type_count()
+    {
+        static std::atomic<long> _held_type_count(0);
+        return _held_type_count;
+    }
+
+    /// Mutex guarding the cache
+    std::mutex mutex;
+    /// Map from selection to HDF5 type; 0 if the selection is empty
+    std::map<key_type, hid_t> type_m;
+}; // struct Compound_Type_Cache
+
 } // namespace detail
 
 /// A map of struct fields to tags that is used to read compound datatypes
@@ -680,7 +792,7 @@ class Compound_Map
 {
 public:
     /// Ctor: default
-    Compound_Map() = default;
+    Compound_Map() : _type_cache(new detail::Compound_Type_Cache()) {}
     /// Ctor: copy
     Compound_Map(Compound_Map const &) = delete;
     /// Ctor: move
@@ -704,6 +816,7 @@ public:
                       or detail::mem_type_class<U>::value == 2
                       or detail::mem_type_class<U>::value == 3,
                       "add_member(name, mem_ptr) overload expects numerical or string types only");
+        clear_type_cache();
         if (detail::mem_type_class<U>::value == 1)
         {
             _members.emplace_back(name, detail::offset_of(mem_ptr), detail::get_mem_type<U>::id());
@@ -731,12 +844,32 @@ public:
     {
         static_assert(detail::mem_type_class<U>::value == 4,
                       "add_member(name, mem_ptr, compound_map_ptr) overload expects class types only");
+        clear_type_cache();
         _members.emplace_back(name, detail::offset_of(mem_ptr), compound_map_ptr, sizeof(U));
     }
 
     /// Get list of compound members.
     std::vector<detail::Compound_Member_Description> const & members() const { return _members; }
 
+    /**
+     * Create a compound map with a subset of the members of this map.
+     * Reading with the projected map only converts the selected members;
+     * other struct fields are left untouched.
+     * @param names Names of top-level members to keep.
+     */
+    Compound_Map project(std::vector<std::string> const & names) const
+    {
+        Compound_Map res;
+        for (auto const & name : names)
+        {
+            auto it = std::find_if(_members.begin(), _members.end(),
+                                   [&] (detail::Compound_Member_Description const & e) { return e.name == name; });
+            if (it == _members.end()) throw Exception("compound member not found: " + name);
+            res._members.push_back(*it);
+        }
+        return res;
+    }
+
     /// Type returned by @p get_member_ptr_list().
     typedef std::deque<std::pair<std::deque<detail::Compound_Member_Description const *>,
                                  size_t>> member_ptr_list_type;
@@ -807,7 +940,7 @@ public:
                     std::string(e.name),
                     std::move(stype_id_holder),
                     fill? e.offset : compressed_size);
-                compressed_size += H5Tget_size(std::get<1>(stype_id_holder_l.back()).id);
+                compressed_size += detail::Util::wrap(H5Tget_size, std::get<1>(stype_id_holder_l.back()).id);
             }
         }
         if (stype_id_holder_l.empty())
@@ -828,6 +961,32 @@ public:
         return res;
     }
 
+    /**
+     * Get an HDF5 compound type for this map, from cache.
+     * Same as @p build_type(), except that the type is built only once for every distinct
+     * selection, and it is owned by this map: the caller must not close it.
+     * Thread-safe.
+     * @return HDF5 type, or 0 if no members are selected.
+     */
+    hid_t get_type(
+        size_t compound_size,
+        std::function<bool(detail::Compound_Member_Description const &)> selector = nullptr,
+        bool fill = true) const
+    {
+        detail::Compound_Type_Cache::key_type key(compound_size, fill, std::vector<bool>());
+        get_selection(selector, std::get<2>(key));
+        detail::Library_Lock library_lock;
+        std::lock_guard<std::mutex> lock(_type_cache->mutex);
+        auto it = _type_cache->type_m.find(key);
+        if (it == _type_cache->type_m.end())
+        {
+            auto id_holder = build_type(compound_size, selector, fill);
+            it = _type_cache->type_m.emplace(std::move(key), id_holder.release()).first;
+            if (it->second > 0) ++detail::Compound_Type_Cache::held_type_count();
+        }
+        return it->second;
+    }
+
     /**
      * Create a flat HDF5 compound type for members in the given list
      * @param l List of compound member descriptions
@@ -896,6 +1055,34 @@ public:
 
 private:
     std::vector<detail::Compound_Member_Description> _members;
+    std::unique_ptr<detail::Compound_Type_Cache> _type_cache;
+
+    /// Compute selection flags of non-compound members, in @p get_member_ptr_list() order.
+    void get_selection(
+        std::function<bool(detail::Compound_Member_Description const &)> const & selector,
+        std::vector<bool> & res) const
+    {
+        for (auto const & e : members())
+        {
+            if (not e.is_compound())
+            {
+                res.push_back(not selector or selector(e));
+            }
+            else
+            {
+                e.compound_map_ptr->get_selection(selector, res);
+            }
+        }
+    }
+
+    /// Drop cached types after the member list changes.
+    void clear_type_cache()
+    {
+        if (not _type_cache) _type_cache.reset(new detail::Compound_Type_Cache());
+        detail::Library_Lock library_lock;
+        std::lock_guard<std::mutex> lock(_type_cache->mutex);
+        _type_cache->clear();
+    }
 }; // Compound_Map
 
 namespace detail
@@ -934,19 +1121,65 @@ struct Reader_Base
         }
         else
         {
-            obj_id_holder = HDF_Object_Holder(
-                Util::wrap(H5Aopen, grp_id, name.c_str(), H5P_DEFAULT),
-                Util::wrapped_closer(H5Aclose));
-            dspace_id_holder = HDF_Object_Holder(
-                Util::wrap(H5Aget_space, obj_id_holder.id),
-                Util::wrapped_closer(H5Sclose));
-            file_dtype_id_holder = HDF_Object_Holder(
-                Util::wrap(H5Aget_type, obj_id_holder.id),
-                Util::wrapped_closer(H5Tclose));
-            reader = [&] (hid_t mem_dtype_id, void * dest) {
-                return Util::wrap(H5Aread, obj_id_holder.id, mem_dtype_id, dest);
-            };
+            init_attribute(HDF_Object_Holder(
+                               Util::wrap(H5Aopen, grp_id, name.c_str(), H5P_DEFAULT),
+                               Util::wrapped_closer(H5Aclose)));
         }
+        init_types();
+    }
+    /**
+     * Ctor: from open HDF5 attribute.
+     * @param attr_id_holder HDF5 attribute object holder
+     */
+    explicit Reader_Base(HDF_Object_Holder && attr_id_holder)
+    {
+        is_ds = false;
+        init_attribute(std::move(attr_id_holder));
+        init_types();
+    }
+    /// Ctor: copy
+    Reader_Base(Reader_Base const &) = delete;
+    /// Asop: copy
+    Reader_Base & operator = (Reader_Base const &) = delete;
+    /// Object holder
+    HDF_Object_Holder obj_id_holder;
+    /// Dataspace holder
+    HDF_Object_Holder dspace_id_holder;
+    /// Datatype holder
+    HDF_Object_Holder file_dtype_id_holder;
+    /// Reader function
+    std::function<void(hid_t, void *)> reader;
+    /// Dataspace class
+    H5S_class_t dspace_class;
+    /// Dataspace size
+    size_t dspace_size;
+    /// Datatype class
+    H5T_class_t file_dtype_class;
+    /// Variable-length string flag
+    htri_t file_dtype_is_vlen_str;
+    /// Datatype size
+    size_t file_dtype_size;
+    /// Is-dataset flag
+    bool is_ds;
+
+private:
+    /// Take over attribute, open its dataspace and datatype.
+    void init_attribute(HDF_Object_Holder && attr_id_holder)
+    {
+        obj_id_holder = std::move(attr_id_holder);
+        dspace_id_holder = HDF_Object_Holder(
+            Util::wrap(H5Aget_space, obj_id_holder.id),
+            Util::wrapped_closer(H5Sclose));
+        file_dtype_id_holder = HDF_Object_Holder(
+            Util::wrap(H5Aget_type, obj_id_holder.id),
+            Util::wrapped_closer(H5Tclose));
+        reader = [&] (hid_t mem_dtype_id, void * dest) {
+            return Util::wrap(H5Aread, obj_id_holder.id, mem_dtype_id, dest);
+        };
+    }
+    /// Compute dataspace and datatype properties.
+    void init_types()
+    {
         // dataspace class and size
         dspace_class = Util::wrap(H5Sget_simple_extent_type, dspace_id_holder.id);
         if (dspace_class == H5S_SCALAR)
@@ -977,27 +1210,8 @@ struct Reader_Base
         }
         // datatype size
         file_dtype_size = Util::wrap(H5Tget_size, file_dtype_id_holder.id);
+        IO_Counts::thread_counts().read_bytes += dspace_size * file_dtype_size;
     }
-    /// Object holder
-    HDF_Object_Holder obj_id_holder;
-    /// Dataspace holder
-    HDF_Object_Holder dspace_id_holder;
-    /// Datatype holder
-    HDF_Object_Holder file_dtype_id_holder;
-    /// Reader function
-    std::function<void(hid_t, void *)> reader;
-    /// Dataspace class
-    H5S_class_t dspace_class;
-    /// Dataspace size
-    size_t dspace_size;
-    /// Datatype class
-    H5T_class_t file_dtype_class;
-    /// Variable-length string flag
-    htri_t file_dtype_is_vlen_str;
-    /// Datatype size
-    size_t file_dtype_size;
-    /// Is-dataset flag
-    bool is_ds;
 }; // struct Reader_Base
 
 /**
@@ -1267,24 +1481,29 @@ struct Reader_Helper
         std::set<detail::Compound_Member_Description const *> conversion_needed_s;
         for (auto const & p : mptr_l)
         {
-            HDF_Object_Holder file_stype_id_holder(
-                Compound_Map::get_compound_member(reader_base.file_dtype_id_holder.id, p.first));
-            if (p.first.back()->is_string()
-                or (p.first.back()->is_char_array()
-                    and Util::wrap(H5Tget_class, file_stype_id_holder.id) == H5T_STRING
-                    and Util::wrap(H5Tis_variable_str, file_stype_id_holder.id)))
+            if (p.first.back()->is_string())
             {
                 conversion_needed_s.insert(p.first.back());
             }
+            else if (p.first.back()->is_char_array())
+            {
+                HDF_Object_Holder file_stype_id_holder(
+                    Compound_Map::get_compound_member(reader_base.file_dtype_id_holder.id, p.first));
+                if (Util::wrap(H5Tget_class, file_stype_id_holder.id) == H5T_STRING
+                    and Util::wrap(H5Tis_variable_str, file_stype_id_holder.id))
+                {
+                    conversion_needed_s.insert(p.first.back());
+                }
+            }
         }
         // read all members that do not need conversion all-at-once
         auto implicit_conversion = [&] (detail::Compound_Member_Description const & e) {
             return conversion_needed_s.count(&e) == 0;
         };
-        HDF_Object_Holder mem_dtype_id_holder(cm.build_type(sizeof(Data_Type), implicit_conversion, true));
-        if (mem_dtype_id_holder.id > 0)
+        hid_t mem_dtype_id = cm.get_type(sizeof(Data_Type), implicit_conversion, true);
+        if (mem_dtype_id > 0)
         {
-            reader_base.reader(mem_dtype_id_holder.id, out);
+            reader_base.reader(mem_dtype_id, out);
         }
         // read members that need conversion one-by-one
         for (auto const & p : mptr_l)
@@ -1357,6 +1576,20 @@ struct Reader
                       Args && ...args) const
     {
         Reader_Base reader_base(grp_id, name);
+        (*this)(reader_base, out, std::forward<Args>(args)...);
+    }
+    /**
+     * Functor operator.
+     * @em Specialization_Default.
+     * @param reader_base File object read manager
+     * @param out Destination (single address)
+     * @param args Optional reading arguments passed to @p Reader_Helper
+     */
+    template <typename ...Args>
+    void operator () (Reader_Base const & reader_base,
+                      Data_Type & out,
+                      Args && ...args) const
+    {
         if (reader_base.dspace_size == 1)
         {
             Reader_Helper<mem_type_class<Data_Type>::value, Data_Type>()(
@@ -1405,6 +1638,20 @@ struct Reader
                       Args && ...args) const
     {
         Reader_Base reader_base(grp_id, name);
+        (*this)(reader_base, out, std::forward<Args>(args)...);
+    }
+    /**
+     * Functor operator.
+     * @em Specialization_Vector.
+     * @param reader_base File object read manager
+     * @param out Destination (vector)
+     * @param args Optional reading arguments passed to @p Reader_Helper
+     */
+    template <typename ...Args>
+    void operator () (Reader_Base const & reader_base,
+                      std::vector<Data_Type> & out,
+                      Args && ...args) const
+    {
         out.clear();
         out.resize(reader_base.dspace_size);
         Reader_Helper<mem_type_class<Data_Type>::value, Data_Type>()(
@@ -1443,6 +1690,8 @@ struct Writer_Base
                            H5P_DEFAULT, H5P_DEFAULT),
                 Util::wrapped_closer(H5Aclose));
         }
+        IO_Counts::thread_counts().write_bytes +=
+            Util::wrap(H5Tget_size, file_dtype_id) * Util::wrap(H5Sget_simple_extent_npoints, dspace_id);
         return obj_id_holder;
     }
     /**
@@ -1684,11 +1933,10 @@ struct Writer_Helper
         // create object
         {
             // create the file type
-            HDF_Object_Holder file_dtype_id_holder(
-                cm.build_type(sizeof(In_Data_Type), nullptr, false));
+            hid_t file_dtype_id = cm.get_type(sizeof(In_Data_Type), nullptr, false);
             obj_id_holder = Writer_Base::create(
                 grp_id, loc_name, as_ds,
-                dspace_id, file_dtype_id_holder.id);
+                dspace_id, file_dtype_id);
         }
         // define functor that selects members which can be written with implicit conversion
         auto implicit_conversion = [] (detail::Compound_Member_Description const & e) {
@@ -1696,9 +1944,8 @@ struct Writer_Helper
         };
         // write fields which do not need conversion, all-in-one
         {
-            HDF_Object_Holder mem_dtype_id_holder(
-                cm.build_type(sizeof(In_Data_Type), implicit_conversion, true));
-            Writer_Base::write(obj_id_holder.id, as_ds, mem_dtype_id_holder.id, in);
+            hid_t mem_dtype_id = cm.get_type(sizeof(In_Data_Type), implicit_conversion, true);
+            Writer_Base::write(obj_id_holder.id, as_ds, mem_dtype_id, in);
         }
         // write fields which need conversion, one-by-one
         {
@@ -1720,13 +1967,13 @@ struct Writer_Helper
                     }
                     // create flat hdf5 type
                     //HDF_Object_Holder mem_dtype_id_holder(Compound_Map::build_flat_type(p.first));
-                    HDF_Object_Holder mem_dtype_id_holder(
-                        cm.build_type(sizeof(In_Data_Type),
-                                      [&e] (detail::Compound_Member_Description const & _e) {
-                                          return &_e == &e;
-                                      },
-                                      false));
-                    Writer_Base::write(obj_id_holder.id, as_ds, mem_dtype_id_holder.id, charptr_buff.data());
+                    hid_t mem_dtype_id =
+                        cm.get_type(sizeof(In_Data_Type),
+                                    [&e] (detail::Compound_Member_Description const & _e) {
+                                        return &_e == &e;
+                                    },
+                                    false);
+                    Writer_Base::write(obj_id_holder.id, as_ds, mem_dtype_id, charptr_buff.data());
                 }
             }
         }
@@ -1821,6 +2068,35 @@ struct Writer
 
 } // namespace detail
 
+/**
+ * Typed destination of a batch attribute read.
+ * @see File::read_attributes()
+ */
+struct Attr_Dest
+{
+    /**
+     * Ctor: from attribute name and destination.
+     * @param _name Attribute name.
+     * @param out Destination (single address or vector reference).
+     * @param _required Flag: if true, the attribute must exist;
+     * if false, @p out is left untouched when the attribute is missing.
+     */
+    template <typename Data_Storage>
+    Attr_Dest(std::string const & _name, Data_Storage & out, bool _required = true)
+        : name(_name),
+          reader([&out] (detail::Reader_Base const & reader_base) {
+                  detail::Reader<Data_Storage>()(reader_base, out);
+              }),
+          required(_required)
+    {}
+    /// Attribute name
+    std::string name;
+    /// Reader function
+    std::function<void(detail::Reader_Base const &)> reader;
+    /// Required flag
+    bool required;
+}; // struct Attr_Dest
+
 /// An HDF5 file reader
 class File
 {
@@ -1829,13 +2105,14 @@ public:
     typedef std::map<std::string, std::string> Attr_Map;
 
     /// Ctor: default
-    File() : _file_id(0) {}
+    File() : _file_id(0), _swmr(false), _object_index_loaded(false), _object_index_valid(false) {}
     /**
      * Ctor: from file name
      * @param file_name File name to open.
      * @param rw Flag: open for writing iff true.
      */
-    File(std::string const & file_name, bool rw = false) : _file_id(0) { open(file_name, rw); }
+    File(std::string const & file_name, bool rw = false)
+        : _file_id(0), _swmr(false), _object_index_loaded(false), _object_index_valid(false) { open(file_name, rw); }
     /// Ctor: copy
     File(File const &) = delete;
     /// Asop: copy
@@ -1847,43 +2124,224 @@ public:
     bool is_open() const { return _file_id > 0; }
     /// Check if file is open for writing.
     bool is_rw() const { return _rw; }
+    /// Check if file is open in SWMR (single writer, multiple readers) mode.
+    bool is_swmr() const { return _swmr; }
     /// Get file name.
     std::string const & file_name() const { return _file_name; }
 
     /**
      * Create file.
+     * In memory mode, the file is assembled in RAM by the HDF5 core driver. On close,
+     * it is written out with one sequential write to a temporary file, which is then
+     * renamed to @p file_name.
+     * With @p swmr, the file is created in the latest HDF5 format, as required by SWMR; objects
+     * are then created as usual, and start_swmr_write() lets readers open the file.
      * @param file_name File name to create.
      * @param truncate Control behaviour if file exists: if true, truncate; if false, fail.
+     * @param in_memory Flag: build file in memory.
+     * @param swmr Flag: create file for SWMR writing.
      */
-    void create(std::string const & file_name, bool truncate = false)
+    void create(std::string const & file_name, bool truncate = false, bool in_memory = false, bool swmr = false)
     {
         if (is_open()) close();
+        if (in_memory and swmr) throw Exception(file_name + ": SWMR files cannot be built in memory");
         _file_name = file_name;
         _rw = true;
-        _file_id = H5Fcreate(file_name.c_str(), truncate? H5F_ACC_TRUNC : H5F_ACC_EXCL, H5P_DEFAULT, H5P_DEFAULT);
+        detail::Library_Lock lock;
+        if (not in_memory)
+        {
+            auto fapl_id_holder = swmr_fapl(swmr);
+            _file_id = H5Fcreate(file_name.c_str(), truncate? H5F_ACC_TRUNC : H5F_ACC_EXCL, H5P_DEFAULT, fapl_id_holder.id);
+        }
+        else
+        {
+            if (not truncate and std::ifstream(file_name)) throw Exception(_file_name + ": file exists");
+            _tmp_file_name = file_name + ".tmp";
+            detail::HDF_Object_Holder fapl_id_holder(
+                detail::Util::wrap(H5Pcreate, H5P_FILE_ACCESS),
+                detail::Util::wrapped_closer(H5Pclose));
+            detail::Util::wrap(H5Pset_fapl_core, fapl_id_holder.id, core_increment(), true);
+            _file_id = H5Fcreate(_tmp_file_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id_holder.id);
+        }
         if (not is_open()) throw Exception(_file_name + ": error in H5Fcreate");
     } // create()
+    /**
+     * Create file in memory only.
+     * The file is never written to disk; use get_image() to retrieve its contents.
+     * @param file_name File name to report for this file.
+     */
+    void create_image(std::string const & file_name)
+    {
+        if (is_open()) close();
+        _file_name = file_name;
+        _rw = true;
+        detail::Library_Lock lock;
+        detail::HDF_Object_Holder fapl_id_holder(
+            detail::Util::wrap(H5Pcreate, H5P_FILE_ACCESS),
+            detail::Util::wrapped_closer(H5Pclose));
+        detail::Util::wrap(H5Pset_fapl_core, fapl_id_holder.id, core_increment(), false);
+        _file_id = H5Fcreate(unique_image_name().c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id_holder.id);
+        if (not is_open()) throw Exception(_file_name + ": error in H5Fcreate");
+    } // create_image()
+    /**
+     * Get file image.
+     * The file is flushed first, so the image reflects all writes so far.
+     */
+    std::vector< char > get_image() const
+    {
+        assert(is_open());
+        detail::Library_Lock lock;
+        if (_rw) detail::Util::wrap(H5Fflush, _file_id, H5F_SCOPE_LOCAL);
+        std::vector< char > res(detail::Util::wrap(H5Fget_file_image, _file_id, nullptr, 0));
+        detail::Util::wrap(H5Fget_file_image, _file_id, res.data(), res.size());
+        return res;
+    } // get_image()
     /**
      * Open file.
+     * With @p swmr, a read-only file is opened for SWMR reading: it can be read while a SWMR
+     * writer extends it, and refresh() picks up the changes. A file open for writing is opened
+     * for SWMR writing, which requires a file in the latest HDF5 format.
      * @param file_name File name to open.
      * @param rw Flag: open for writing iff true.
+     * @param swmr Flag: open in SWMR mode.
      */
-    void open(std::string const & file_name, bool rw = false)
+    void open(std::string const & file_name, bool rw = false, bool swmr = false)
     {
         if (is_open()) close();
         _file_name = file_name;
         _rw = rw;
-        _file_id = H5Fopen(file_name.c_str(), not rw? H5F_ACC_RDONLY : H5F_ACC_RDWR, H5P_DEFAULT);
+        detail::Library_Lock lock;
+        unsigned flags = (not rw
+                          ? H5F_ACC_RDONLY | (swmr? H5F_ACC_SWMR_READ : 0)
+                          : H5F_ACC_RDWR | (swmr? H5F_ACC_SWMR_WRITE : 0));
+        auto fapl_id_holder = swmr_fapl(swmr and rw);
+        _file_id = H5Fopen(file_name.c_str(), flags, fapl_id_holder.id);
         if (not is_open()) throw Exception(_file_name + ": error in H5Fopen");
+        _swmr = swmr;
     } // open()
+    /**
+     * Switch a file created for SWMR writing to SWMR mode, letting readers open it.
+     * Objects should be created before this call: readers are not guaranteed to see objects
+     * and attributes created afterwards, only dataset extensions and writes to existing ones.
+     */
+    void start_swmr_write()
+    {
+        assert(is_open());
+        assert(is_rw());
+        detail::Library_Lock lock;
+        detail::Util::wrap(H5Fstart_swmr_write, _file_id);
+        _swmr = true;
+    } // start_swmr_write()
+    /// Flush file; in SWMR writing, this makes writes so far visible to readers.
+    void flush() const
+    {
+        assert(is_open());
+        detail::Library_Lock lock;
+        detail::Util::wrap(H5Fflush, _file_id, H5F_SCOPE_LOCAL);
+    } // flush()
+    /**
+     * Refresh an object in SWMR reading: drop its cached metadata, so that the next access
+     * sees the changes made by the writer, e.g. the new extent of a dataset.
+     * @param loc_full_name Full path of a group or dataset.
+     */
+    void refresh(std::string const & loc_full_name) const
+    {
+        assert(is_open());
+        Exception::active_path() = loc_full_name;
+        detail::HDF_Object_Holder obj_id_holder(
+            detail::Util::wrap(H5Oopen, _file_id, loc_full_name.c_str(), H5P_DEFAULT),
+            detail::Util::wrapped_closer(H5Oclose));
+        detail::Util::wrap(H5Orefresh, obj_id_holder.id);
+    } // refresh()
+    /**
+     * Open file from an in-memory file image.
+     * The image is passed to the HDF5 core driver, which makes its own copy,
+     * so the buffer can be released after this call. The file is read-only.
+     * @param image_ptr Pointer to file image.
+     * @param image_size Size of file image.
+     * @param file_name File name to report for this file.
+     */
+    void open_image(void const * image_ptr, size_t image_size, std::string const & file_name)
+    {
+        if (is_open()) close();
+        _file_name = file_name;
+        _rw = false;
+        detail::Library_Lock lock;
+        detail::HDF_Object_Holder fapl_id_holder(
+            detail::Util::wrap(H5Pcreate, H5P_FILE_ACCESS),
+            detail::Util::wrapped_closer(H5Pclose));
+        detail::Util::wrap(H5Pset_fapl_core, fapl_id_holder.id, image_size > 0? image_size : 1, false);
+        detail::Util::wrap(H5Pset_file_image, fapl_id_holder.id, const_cast< void * >(image_ptr), image_size);
+        _file_id = H5Fopen(unique_image_name().c_str(), H5F_ACC_RDONLY, fapl_id_holder.id);
+        if (not is_open()) throw Exception(_file_name + ": error in H5Fopen");
+    } // open_image()
+    /**
+     * Open file from an in-memory file image.
+     * @param image File image.
+     * @param file_name File name to report for this file.
+     */
+    void open_image(std::vector< char > const & image, std::string const & file_name)
+    {
+        open_image(image.data(), image.size(), file_name);
+    } // open_image()
+    /**
+     * Open file by loading it into memory.
+     * The file is read with a single sequential read, then opened as a file image;
+     * all subsequent HDF5 calls are served from memory. The file is read-only.
+     * @param file_name File name to open.
+     */
+    void open_in_memory(std::string const & file_name)
+    {
+        open_image(read_image(file_name), file_name);
+    } // open_in_memory()
+    /**
+     * Open another handle to a file that is already open.
+     * The new handle shares the underlying file and its access mode with @p other;
+     * the file stays open until all handles are closed. If @p other was created through
+     * a temporary file, it must be closed last, as it renames that file on close.
+     * @param other Open file.
+     */
+    void reopen(File const & other)
+    {
+        assert(other.is_open());
+        if (is_open()) close();
+        _file_name = other._file_name;
+        _rw = other._rw;
+        _swmr = other._swmr;
+        detail::Library_Lock lock;
+        _file_id = H5Freopen(other._file_id);
+        if (not is_open()) throw Exception(_file_name + ": error in H5Freopen");
+    } // reopen()
+    /**
+     * Read entire file into memory.
+     * @param file_name File name to read.
+     */
+    static std::vector< char > read_image(std::string const & file_name)
+    {
+        std::ifstream ifs(file_name, std::ios::binary | std::ios::ate);
+        if (not ifs) throw Exception(file_name + ": error opening file");
+        std::vector< char > res(static_cast< size_t >(ifs.tellg()));
+        ifs.seekg(0);
+        if (not ifs.read(res.data(), res.size())) throw Exception(file_name + ": error reading file");
+        return res;
+    } // read_image()
     /// Close file
     void close()
     {
         if (not is_open()) return;
+        detail::Library_Lock lock;
         if (H5Fget_obj_count(_file_id, H5F_OBJ_ALL | H5F_OBJ_LOCAL) != 1) throw Exception(_file_name + ": HDF5 memory leak");
         int status = H5Fclose(_file_id);
         if (status < 0) throw Exception(_file_name + ": error in H5Fclose");
         _file_id = 0;
+        _swmr = false;
+        set_object_index_root(std::string());
+        if (not _tmp_file_name.empty())
+        {
+            status = std::rename(_tmp_file_name.c_str(), _file_name.c_str());
+            _tmp_file_name.clear();
+            if (status != 0) throw Exception(_file_name + ": error in rename");
+        }
         _file_name.clear();
     } // close()
     /// Check if file name is a valid HDF5 file.
@@ -1894,6 +2352,7 @@ public:
         (void)ifs.peek();
         if (not ifs) return false;
         ifs.close();
+        detail::Library_Lock lock;
         auto status = H5Fis_hdf5(file_name.c_str());
         if (status <= 0) return 0;
         auto file_id = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT); // error if file is truncated
@@ -1903,12 +2362,56 @@ public:
         return 1;
     } // is_valid_file()
 
-    /// Get HDF5 object count.
+    /// Get HDF5 object count, excluding types held by compound type caches.
     static int get_object_count()
     {
-        return H5Fget_obj_count(H5F_OBJ_ALL, H5F_OBJ_ALL);
+        detail::Library_Lock lock;
+        return H5Fget_obj_count(H5F_OBJ_ALL, H5F_OBJ_ALL) - detail::Compound_Type_Cache::held_type_count();
     } // get_object_count()
 
+    /// Profile of HDF5 calls: call counts and cumulative times by function and by path prefix.
+    typedef detail::Profiler::Profile Profile;
+    /**
+     * Enable or disable profiling of HDF5 calls, made from all threads.
+     * @param enable Flag.
+     * @param prefix_depth Number of path components of the path prefixes used in the profile.
+     */
+    static void set_profiling(bool enable, unsigned prefix_depth = 3)
+    {
+        detail::Profiler::enable(enable, prefix_depth);
+    }
+    /// Get the profile of HDF5 calls made since profiling was enabled or reset.
+    static Profile get_profile() { return detail::Profiler::get(); }
+    /// Reset the profile of HDF5 calls.
+    static void reset_profile() { detail::Profiler::reset(); }
+    /// Print the profile of HDF5 calls, sorted by decreasing cumulative time.
+    static void print_profile(std::ostream & os) { detail::Profiler::print(os); }
+
+    /**
+     * Set the root of the object index.
+     * The object index maps the paths of all groups and datasets under @p root to their
+     * object types. It is built on the first existence check of a path under @p root, with
+     * one recursive visit of the objects and one of the links, and it is then used to answer
+     * group_exists(), dataset_exists() and group_or_dataset_exists() for such paths without
+     * further HDF5 calls. Writes through this object keep the index up to date; writes
+     * through other handles to the same file are not seen. Subtrees with soft or external
+     * links, or with groups reachable through several hard links, are not indexed, and
+     * checks in them are made through HDF5 as usual.
+     * The index is disabled by default, and on close.
+     * @param root Full path of the indexed subtree; if empty, the index is disabled.
+     */
+    void
+    set_object_index_root(std::string const & root) const
+    {
+        assert(root.empty() or root.front() == '/');
+        _object_index_root = root;
+        _object_index_loaded = false;
+        _object_index_valid = false;
+        _object_index.clear();
+    } // set_object_index_root()
+    /// Get the root of the object index; empty if the index is disabled.
+    std::string const & get_object_index_root() const { return _object_index_root; }
+
     /**
      * Check if an object exists that is a group.
      * @param loc_full_name Full path.
@@ -1919,6 +2422,8 @@ public:
         assert(is_open());
         assert(not loc_full_name.empty() and loc_full_name.front() == '/');
         if (loc_full_name == "/") return true;
+        H5O_type_t type;
+        if (object_index_lookup(loc_full_name, type)) return type == H5O_TYPE_GROUP;
         auto && loc = split_full_name(loc_full_name);
         // check all path elements exist, except for what is to the right of the last '/'
         // sets active path
@@ -1934,6 +2439,8 @@ public:
         assert(is_open());
         assert(not loc_full_name.empty() and loc_full_name.front() == '/');
         if (loc_full_name == "/") return false;
+        H5O_type_t type;
+        if (object_index_lookup(loc_full_name, type)) return type == H5O_TYPE_DATASET;
         auto && loc = split_full_name(loc_full_name);
         // check all path elements exist, except for what is to the right of the last '/'
         // sets active path
@@ -1949,6 +2456,8 @@ public:
         assert(is_open());
         assert(not loc_full_name.empty() and loc_full_name.front() == '/');
         if (loc_full_name == "/") return true;
+        H5O_type_t type;
+        if (object_index_lookup(loc_full_name, type)) return type == H5O_TYPE_GROUP or type == H5O_TYPE_DATASET;
         auto && loc = split_full_name(loc_full_name);
         // check all path elements exist, except for what is to the right of the last '/'
         // sets active path
@@ -1971,6 +2480,7 @@ public:
         // sets active path
         if (not group_or_dataset_exists(loc.first)) return false;
         // check if target is an attribute
+        detail::Library_Lock lock;
         int status = H5Aexists_by_name(_file_id, loc.first.c_str(), loc.second.c_str(), H5P_DEFAULT);
         if (status < 0) throw Exception("error in H5Aexists_by_name");
         return status > 0;
@@ -2022,25 +2532,85 @@ public:
         assert(not exists(loc_full_name));
         auto && loc = split_full_name(loc_full_name);
         Exception::active_path() = loc_full_name;
-        detail::HDF_Object_Holder grp_id_holder;
-        if (group_or_dataset_exists(loc.first))
-        {
-            grp_id_holder = detail::HDF_Object_Holder(
-                detail::Util::wrap(H5Oopen, _file_id, loc.first.c_str(), H5P_DEFAULT),
-                detail::Util::wrapped_closer(H5Oclose));
-        }
-        else
-        {
-            detail::HDF_Object_Holder lcpl_id_holder(
-                detail::Util::wrap(H5Pcreate, H5P_LINK_CREATE),
-                detail::Util::wrapped_closer(H5Pclose));
-            detail::Util::wrap(H5Pset_create_intermediate_group, lcpl_id_holder.id, 1);
-            grp_id_holder = detail::HDF_Object_Holder(
-                detail::Util::wrap(H5Gcreate2, _file_id, loc.first.c_str(), lcpl_id_holder.id, H5P_DEFAULT, H5P_DEFAULT),
-                detail::Util::wrapped_closer(H5Gclose));
-        }
+        auto grp_id_holder = open_or_create_group(loc.first);
         detail::Writer<In_Data_Storage>()(grp_id_holder.id, loc.second, as_ds, in, std::forward<Args>(args)...);
+        if (as_ds) object_index_insert(loc_full_name, H5O_TYPE_DATASET);
     } // write()
+    /**
+     * Create an empty one-dimensional dataset, to be extended by append_dataset().
+     * The dataset is chunked, with unlimited maximum size.
+     * @param loc_full_name Full path.
+     * @param chunk_size Number of elements per chunk.
+     */
+    template <typename Data_Type>
+    void
+    create_extendible_dataset(std::string const & loc_full_name, size_t chunk_size) const
+    {
+        static_assert(std::is_integral<Data_Type>::value or std::is_floating_point<Data_Type>::value,
+                      "extendible datasets hold numeric elements");
+        assert(is_open());
+        assert(is_rw());
+        assert(not loc_full_name.empty() and loc_full_name[0] == '/');
+        assert(not exists(loc_full_name));
+        assert(chunk_size > 0);
+        auto && loc = split_full_name(loc_full_name);
+        Exception::active_path() = loc_full_name;
+        auto grp_id_holder = open_or_create_group(loc.first);
+        hsize_t sz = 0;
+        hsize_t max_sz = H5S_UNLIMITED;
+        hsize_t chunk_sz = chunk_size;
+        detail::HDF_Object_Holder dspace_id_holder(
+            detail::Util::wrap(H5Screate_simple, 1, &sz, &max_sz),
+            detail::Util::wrapped_closer(H5Sclose));
+        detail::HDF_Object_Holder dcpl_id_holder(
+            detail::Util::wrap(H5Pcreate, H5P_DATASET_CREATE),
+            detail::Util::wrapped_closer(H5Pclose));
+        detail::Util::wrap(H5Pset_chunk, dcpl_id_holder.id, 1, &chunk_sz);
+        hid_t dtype_id = detail::get_mem_type<Data_Type>::id();
+        detail::HDF_Object_Holder ds_id_holder(
+            detail::Util::wrap(H5Dcreate2, grp_id_holder.id, loc.second.c_str(), dtype_id, dspace_id_holder.id,
+                               H5P_DEFAULT, dcpl_id_holder.id, H5P_DEFAULT),
+            detail::Util::wrapped_closer(H5Dclose));
+        object_index_insert(loc_full_name, H5O_TYPE_DATASET);
+    } // create_extendible_dataset()
+    /**
+     * Append elements to a dataset created by create_extendible_dataset().
+     * @param loc_full_name Full path.
+     * @param in Source address.
+     * @param n Number of elements.
+     */
+    template <typename Data_Type>
+    void
+    append_dataset(std::string const & loc_full_name, Data_Type const * in, size_t n) const
+    {
+        assert(is_open());
+        assert(is_rw());
+        if (n == 0) return;
+        Exception::active_path() = loc_full_name;
+        detail::HDF_Object_Holder ds_id_holder(
+            detail::Util::wrap(H5Dopen, _file_id, loc_full_name.c_str(), H5P_DEFAULT),
+            detail::Util::wrapped_closer(H5Dclose));
+        hsize_t sz;
+        {
+            detail::HDF_Object_Holder dspace_id_holder(
+                detail::Util::wrap(H5Dget_space, ds_id_holder.id),
+                detail::Util::wrapped_closer(H5Sclose));
+            detail::Util::wrap(H5Sget_simple_extent_dims, dspace_id_holder.id, &sz, nullptr);
+        }
+        hsize_t cnt = n;
+        hsize_t new_sz = sz + cnt;
+        detail::Util::wrap(H5Dset_extent, ds_id_holder.id, &new_sz);
+        detail::HDF_Object_Holder fspace_id_holder(
+            detail::Util::wrap(H5Dget_space, ds_id_holder.id),
+            detail::Util::wrapped_closer(H5Sclose));
+        detail::Util::wrap(H5Sselect_hyperslab, fspace_id_holder.id, H5S_SELECT_SET, &sz, nullptr, &cnt, nullptr);
+        detail::HDF_Object_Holder mspace_id_holder(
+            detail::Util::wrap(H5Screate_simple, 1, &cnt, nullptr),
+            detail::Util::wrapped_closer(H5Sclose));
+        detail::Util::wrap(H5Dwrite, ds_id_holder.id, detail::get_mem_type<Data_Type>::id(),
+                           mspace_id_holder.id, fspace_id_holder.id, H5P_DEFAULT, in);
+        IO_Counts::thread_counts().write_bytes += n * sizeof(Data_Type);
+    } // append_dataset()
     /**
      * Write dataset.
      * @param loc_full_name Full path.
@@ -2065,10 +2635,72 @@ public:
     {
         write(loc_full_name, false, in, std::forward<Args>(args)...);
     } // write_attribute()
+    /**
+     * Overwrite the value of an existing numeric attribute.
+     * Unlike creating attributes, this is supported in SWMR writing.
+     * @param loc_full_name Full path.
+     * @param in Source.
+     */
+    template <typename Data_Type>
+    void
+    update_attribute(std::string const & loc_full_name, Data_Type const & in) const
+    {
+        static_assert(std::is_integral<Data_Type>::value or std::is_floating_point<Data_Type>::value,
+                      "only numeric attributes can be updated");
+        assert(is_open());
+        assert(is_rw());
+        auto && loc = split_full_name(loc_full_name);
+        Exception::active_path() = loc_full_name;
+        detail::HDF_Object_Holder obj_id_holder(
+            detail::Util::wrap(H5Oopen, _file_id, loc.first.c_str(), H5P_DEFAULT),
+            detail::Util::wrapped_closer(H5Oclose));
+        detail::HDF_Object_Holder attr_id_holder(
+            detail::Util::wrap(H5Aopen, obj_id_holder.id, loc.second.c_str(), H5P_DEFAULT),
+            detail::Util::wrapped_closer(H5Aclose));
+        detail::Util::wrap(H5Awrite, attr_id_holder.id, detail::get_mem_type<Data_Type>::id(), &in);
+        IO_Counts::thread_counts().write_bytes += sizeof(Data_Type);
+    } // update_attribute()
+    /**
+     * Create group, along with any missing intermediate groups.
+     * @param group_full_name Full path.
+     */
+    void
+    create_group(std::string const & group_full_name) const
+    {
+        assert(is_open());
+        assert(is_rw());
+        assert(not group_full_name.empty() and group_full_name[0] == '/');
+        assert(not exists(group_full_name));
+        Exception::active_path() = group_full_name;
+        detail::HDF_Object_Holder lcpl_id_holder(
+            detail::Util::wrap(H5Pcreate, H5P_LINK_CREATE),
+            detail::Util::wrapped_closer(H5Pclose));
+        detail::Util::wrap(H5Pset_create_intermediate_group, lcpl_id_holder.id, 1);
+        detail::HDF_Object_Holder grp_id_holder(
+            detail::Util::wrap(H5Gcreate2, _file_id, group_full_name.c_str(), lcpl_id_holder.id, H5P_DEFAULT, H5P_DEFAULT),
+            detail::Util::wrapped_closer(H5Gclose));
+        object_index_insert(group_full_name, H5O_TYPE_GROUP);
+    } // create_group()
+    /**
+     * Remove group or dataset.
+     * The link is removed; HDF5 does not reclaim the space used by the object.
+     * @param loc_full_name Full path.
+     */
+    void
+    remove(std::string const & loc_full_name) const
+    {
+        assert(is_open());
+        assert(is_rw());
+        assert(not loc_full_name.empty() and loc_full_name[0] == '/');
+        Exception::active_path() = loc_full_name;
+        detail::Util::wrap(H5Ldelete, _file_id, loc_full_name.c_str(), H5P_DEFAULT);
+        object_index_erase(loc_full_name);
+    } // remove()
 
     /**
      * List group.
      * Return a list of names (groups/datasets) in the given group.
+     * The group is opened once, and its links are visited in a single H5Literate pass.
      * @param group_full_name Full path.
      */
     std::vector<std::string>
@@ -2080,21 +2712,40 @@ public:
         detail::HDF_Object_Holder g_id_holder(
             detail::Util::wrap(H5Gopen2, _file_id, group_full_name.c_str(), H5P_DEFAULT),
             detail::Util::wrapped_closer(H5Gclose));
-        H5G_info_t g_info;
-        detail::Util::wrap(H5Gget_info, g_id_holder.id, &g_info);
-        res.resize(g_info.nlinks);
-        for (unsigned i = 0; i < res.size(); ++i)
-        {
-            // find size first
-            long sz1 = detail::Util::wrap(H5Lget_name_by_idx, _file_id, group_full_name.c_str(),
-                                          H5_INDEX_NAME, H5_ITER_NATIVE, i, nullptr, 0, H5P_DEFAULT);
-            res[i].resize(sz1);
-            long sz2 = detail::Util::wrap(H5Lget_name_by_idx, _file_id, group_full_name.c_str(),
-                                          H5_INDEX_NAME, H5_ITER_NATIVE, i, &res[i][0], sz1+1, H5P_DEFAULT);
-            if (sz1 != sz2) throw Exception("error in H5Lget_name_by_idx: sz1!=sz2");
-        }
+        iterate_links(g_id_holder.id, [&] (std::string const & name, hid_t, H5L_info_t const &) {
+                res.push_back(name);
+            });
         return res;
     } // list_group()
+    /**
+     * List group, with object types.
+     * Return a list of (name, object type) pairs for the links in the given group.
+     * Links that do not resolve to an object in this file get type H5O_TYPE_UNKNOWN.
+     * @param group_full_name Full path.
+     */
+    std::vector<std::pair<std::string, H5O_type_t>>
+    list_group_types(std::string const & group_full_name) const
+    {
+        std::vector<std::pair<std::string, H5O_type_t>> res;
+        Exception::active_path() = group_full_name;
+        assert(group_exists(group_full_name));
+        detail::HDF_Object_Holder g_id_holder(
+            detail::Util::wrap(H5Gopen2, _file_id, group_full_name.c_str(), H5P_DEFAULT),
+            detail::Util::wrapped_closer(H5Gclose));
+        iterate_links(g_id_holder.id, [&] (std::string const & name, hid_t g_id, H5L_info_t const & l_info) {
+                H5O_type_t type = H5O_TYPE_UNKNOWN;
+                if (l_info.type == H5L_TYPE_HARD
+                    or (l_info.type == H5L_TYPE_SOFT
+                        and detail::Util::wrap(H5Oexists_by_name, g_id, name.c_str(), H5P_DEFAULT)))
+                {
+                    H5O_info_t o_info;
+                    detail::Util::wrap(H5Oget_info_by_name, g_id, name.c_str(), &o_info, H5P_DEFAULT);
+                    type = o_info.type;
+                }
+                res.emplace_back(name, type);
+            });
+        return res;
+    } // list_group_types()
     /**
      * List attributes.
      * Return a list of attribute names of the given object.
@@ -2109,22 +2760,14 @@ public:
         detail::HDF_Object_Holder id_holder(
             detail::Util::wrap(H5Oopen, _file_id, loc_full_name.c_str(), H5P_DEFAULT),
             detail::Util::wrapped_closer(H5Oclose));
-        H5O_info_t info;
-        detail::Util::wrap(H5Oget_info, id_holder.id, &info);
-        // num_attrs in info.num_attrs
-        for (unsigned i = 0; i < (unsigned)info.num_attrs; ++i)
-        {
-            int name_sz = detail::Util::wrap(H5Aget_name_by_idx, id_holder.id, ".",
-                                             H5_INDEX_NAME, H5_ITER_NATIVE, i, nullptr, 0, H5P_DEFAULT);
-            std::string tmp(name_sz, '\0');
-            detail::Util::wrap(H5Aget_name_by_idx, id_holder.id, ".",
-                               H5_INDEX_NAME, H5_ITER_NATIVE, i, &tmp[0], name_sz + 1, H5P_DEFAULT);
-            res.emplace_back(std::move(tmp));
-        }
+        iterate_attributes(id_holder.id, [&] (std::string const & a, hid_t) {
+                res.push_back(a);
+            });
         return res;
     } // get_attr_list()
     /**
      * Read attribute map.
+     * Each object is opened once, and its attributes are read in a single pass.
      * @param path Full path.
      * @param recurse Flag: if true, recurse into subgroups.
      */
@@ -2139,12 +2782,19 @@ public:
             auto pt = q.front();
             q.pop();
             auto full_path = pt.empty()? path : path + "/" + pt;
-            auto a_list = get_attr_list(full_path);
-            for (auto const & a : a_list)
+            Exception::active_path() = full_path;
+            assert(group_or_dataset_exists(full_path));
             {
-                std::string tmp;
-                read(full_path + "/" + a, tmp);
-                res[pt.empty()? a : pt + "/" + a] = tmp;
+                detail::HDF_Object_Holder id_holder(
+                    detail::Util::wrap(H5Oopen, _file_id, full_path.c_str(), H5P_DEFAULT),
+                    detail::Util::wrapped_closer(H5Oclose));
+                iterate_attributes(id_holder.id, [&] (std::string const & a, hid_t obj_id) {
+                        detail::Reader_Base reader_base(
+                            detail::HDF_Object_Holder(
+                                detail::Util::wrap(H5Aopen, obj_id, a.c_str(), H5P_DEFAULT),
+                                detail::Util::wrapped_closer(H5Aclose)));
+                        detail::Reader<std::string>()(reader_base, res[pt.empty()? a : pt + "/" + a]);
+                    });
             }
             if (recurse and group_exists(full_path))
             {
@@ -2157,6 +2807,51 @@ public:
         }
         return res;
     } // get_attr_map()
+    /**
+     * Read attributes in batch.
+     * Open object once, visit its attributes in a single H5Aiterate2 pass,
+     * and read the requested ones directly into typed destinations.
+     * Attributes not in @p dest_l are skipped.
+     * @param loc_full_name Full path of group or dataset.
+     * @param dest_l List of attribute destinations.
+     */
+    void
+    read_attributes(std::string const & loc_full_name, std::initializer_list<Attr_Dest> dest_l) const
+    {
+        assert(is_open());
+        assert(not loc_full_name.empty() and loc_full_name[0] == '/');
+        Exception::active_path() = loc_full_name;
+        detail::HDF_Object_Holder id_holder(
+            detail::Util::wrap(H5Oopen, _file_id, loc_full_name.c_str(), H5P_DEFAULT),
+            detail::Util::wrapped_closer(H5Oclose));
+        std::vector<bool> found(dest_l.size(), false);
+        iterate_attributes(id_holder.id, [&] (std::string const & a, hid_t obj_id) {
+                unsigned i = 0;
+                for (auto const & dest : dest_l)
+                {
+                    if (dest.name == a)
+                    {
+                        detail::Reader_Base reader_base(
+                            detail::HDF_Object_Holder(
+                                detail::Util::wrap(H5Aopen, obj_id, a.c_str(), H5P_DEFAULT),
+                                detail::Util::wrapped_closer(H5Aclose)));
+                        dest.reader(reader_base);
+                        found[i] = true;
+                        break;
+                    }
+                    ++i;
+                }
+            });
+        unsigned i = 0;
+        for (auto const & dest : dest_l)
+        {
+            if (dest.required and not found[i])
+            {
+                throw Exception(loc_full_name + ": missing attribute: " + dest.name);
+            }
+            ++i;
+        }
+    } // read_attributes()
     /**
      * Write attribute map.
      * @param path Full path.
@@ -2239,6 +2934,7 @@ public:
         // compute paths
         auto && src_path = split_full_name(src_full_path);
         auto && dst_path = split_full_name(dst_full_path);
+        detail::Library_Lock lock;
         // open source attribute
         detail::HDF_Object_Holder src_attr_id_holder(
             detail::Util::wrap(H5Aopen_by_name, src_f._file_id, src_path.first.c_str(), src_path.second.c_str(),
@@ -2328,30 +3024,91 @@ public:
     static void
     copy_attributes(File const & src_f, File const & dst_f, std::string const & path, bool recurse = false)
     {
-        auto a_l = src_f.get_attr_list(not path.empty()? path : std::string("/"));
+        copy_attributes(src_f, dst_f, path, path, recurse);
+    } // copy_attributes()
+    /**
+     * Copy attributes between files, to a different path.
+     * @param src_f Source file.
+     * @param dst_f Destination file.
+     * @param src_path Source path.
+     * @param dst_path Destination path.
+     * @param recurse Flag; if true, recurse.
+     */
+    static void
+    copy_attributes(File const & src_f, File const & dst_f,
+                    std::string const & src_path, std::string const & dst_path, bool recurse)
+    {
+        auto a_l = src_f.get_attr_list(not src_path.empty()? src_path : std::string("/"));
         for (auto const & a : a_l)
         {
-            copy_attribute(src_f, dst_f, path + "/" + a);
+            copy_attribute(src_f, dst_f, src_path + "/" + a, dst_path + "/" + a);
         }
         if (not recurse) return;
-        auto sg_l = src_f.list_group(not path.empty()? path : std::string("/"));
+        auto sg_l = src_f.list_group(not src_path.empty()? src_path : std::string("/"));
         for (auto const & sg : sg_l)
         {
-            if (src_f.group_exists(path + "/" + sg))
+            if (src_f.group_exists(src_path + "/" + sg))
             {
-                copy_attributes(src_f, dst_f, path + "/" + sg, true);
+                copy_attributes(src_f, dst_f, src_path + "/" + sg, dst_path + "/" + sg, true);
             }
         }
     } // copy_attributes()
 private:
     std::string _file_name;
+    std::string _tmp_file_name;
     hid_t _file_id;
     bool _rw;
+    bool _swmr;
+    // object index: full path -> object type, for the subtree at _object_index_root
+    mutable std::string _object_index_root;
+    mutable std::map< std::string, H5O_type_t > _object_index;
+    mutable bool _object_index_loaded;
+    mutable bool _object_index_valid;
+
+    /// Allocation increment of the core driver, used for files created in memory.
+    static size_t core_increment() { return 1u << 24; }
+    /// The core driver refuses an image whose name exists on disk, so images get unique internal names.
+    static std::string unique_image_name()
+    {
+        static std::atomic< unsigned long > image_count(0);
+        return "hdf5_tools_file_image_" + std::to_string(image_count++);
+    }
 
     /**
      * Split a full name into path and name.
      * Note: @p full_name must begin with '/', and not end with '/' unless it equals "/".
      */
+    /// File access properties: the default ones, or those of SWMR writing.
+    static detail::HDF_Object_Holder
+    swmr_fapl(bool swmr)
+    {
+        if (not swmr) return detail::HDF_Object_Holder(H5P_DEFAULT, nullptr);
+        detail::HDF_Object_Holder fapl_id_holder(
+            detail::Util::wrap(H5Pcreate, H5P_FILE_ACCESS),
+            detail::Util::wrapped_closer(H5Pclose));
+        detail::Util::wrap(H5Pset_libver_bounds, fapl_id_holder.id, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+        return fapl_id_holder;
+    }
+    /// Open a group, or create it along with any missing intermediate groups.
+    detail::HDF_Object_Holder
+    open_or_create_group(std::string const & group_full_name) const
+    {
+        if (group_or_dataset_exists(group_full_name))
+        {
+            return detail::HDF_Object_Holder(
+                detail::Util::wrap(H5Oopen, _file_id, group_full_name.c_str(), H5P_DEFAULT),
+                detail::Util::wrapped_closer(H5Oclose));
+        }
+        detail::HDF_Object_Holder lcpl_id_holder(
+            detail::Util::wrap(H5Pcreate, H5P_LINK_CREATE),
+            detail::Util::wrapped_closer(H5Pclose));
+        detail::Util::wrap(H5Pset_create_intermediate_group, lcpl_id_holder.id, 1);
+        detail::HDF_Object_Holder grp_id_holder(
+            detail::Util::wrap(H5Gcreate2, _file_id, group_full_name.c_str(), lcpl_id_holder.id, H5P_DEFAULT, H5P_DEFAULT),
+            detail::Util::wrapped_closer(H5Gclose));
+        object_index_insert(group_full_name, H5O_TYPE_GROUP);
+        return grp_id_holder;
+    } // open_or_create_group()
     static std::pair<std::string, std::string>
     split_full_name(std::string const & full_name)
     {
@@ -2396,6 +3153,72 @@ private:
         return true;
     } // path_exists()
 
+    /**
+     * Iterate over the attributes of an open object, using H5Aiterate2.
+     * Exceptions thrown by @p f are captured, and rethrown after the iteration is stopped.
+     * @param obj_id HDF5 object.
+     * @param f Functor called as f(attribute name, @p obj_id).
+     */
+    static void
+    iterate_attributes(hid_t obj_id, std::function<void(std::string const &, hid_t)> const & f)
+    {
+        struct Op_Data
+        {
+            std::function<void(std::string const &, hid_t)> const * f_ptr;
+            std::exception_ptr e_ptr;
+        } op_data{ &f, nullptr };
+        auto op = [] (hid_t loc_id, char const * attr_name, H5A_info_t const *, void * vp) -> herr_t {
+            auto & d = *static_cast<Op_Data *>(vp);
+            try
+            {
+                (*d.f_ptr)(attr_name, loc_id);
+            }
+            catch (...)
+            {
+                d.e_ptr = std::current_exception();
+                return -1;
+            }
+            return 0;
+        };
+        detail::Library_Lock lock;
+        herr_t status = H5Aiterate2(obj_id, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, op, &op_data);
+        if (op_data.e_ptr) std::rethrow_exception(op_data.e_ptr);
+        if (status < 0) throw Exception("error in H5Aiterate2");
+    } // iterate_attributes()
+
+    /**
+     * Iterate over the links of an open group, using H5Literate.
+     * Exceptions thrown by @p f are captured, and rethrown after the iteration is stopped.
+     * @param g_id HDF5 group.
+     * @param f Functor called as f(link name, @p g_id, link info).
+     */
+    static void
+    iterate_links(hid_t g_id, std::function<void(std::string const &, hid_t, H5L_info_t const &)> const & f)
+    {
+        struct Op_Data
+        {
+            std::function<void(std::string const &, hid_t, H5L_info_t const &)> const * f_ptr;
+            std::exception_ptr e_ptr;
+        } op_data{ &f, nullptr };
+        auto op = [] (hid_t loc_id, char const * name, H5L_info_t const * info, void * vp) -> herr_t {
+            auto & d = *static_cast<Op_Data *>(vp);
+            try
+            {
+                (*d.f_ptr)(name, loc_id, *info);
+            }
+            catch (...)
+            {
+                d.e_ptr = std::current_exception();
+                return -1;
+            }
+            return 0;
+        };
+        detail::Library_Lock lock;
+        herr_t status = H5Literate(g_id, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, op, &op_data);
+        if (op_data.e_ptr) std::rethrow_exception(op_data.e_ptr);
+        if (status < 0) throw Exception("error in H5Literate");
+    } // iterate_links()
+
     /// Check if HDF5 object has given type
     bool
     check_object_type(std::string const & loc_full_name, H5O_type_t type_id) const
@@ -2414,6 +3237,177 @@ private:
         detail::Util::wrap(H5Oget_info, o_id_holder.id, &o_info);
         return o_info.type == type_id;
     } // check_object_type()
+
+    /**
+     * Visit the objects reachable from an open group, using H5Ovisit2.
+     * @param g_id HDF5 group.
+     * @param obj_m Destination map: object address -> (object type, reference count).
+     */
+    static void
+    visit_objects(hid_t g_id, std::map< haddr_t, std::pair< H5O_type_t, unsigned > > & obj_m)
+    {
+        struct Op_Data
+        {
+            std::map< haddr_t, std::pair< H5O_type_t, unsigned > > * obj_m_ptr;
+            std::exception_ptr e_ptr;
+        } op_data{ &obj_m, nullptr };
+        auto op = [] (hid_t, char const *, H5O_info_t const * info, void * vp) -> herr_t {
+            auto & d = *static_cast<Op_Data *>(vp);
+            try
+            {
+                (*d.obj_m_ptr)[info->addr] = std::make_pair(info->type, info->rc);
+            }
+            catch (...)
+            {
+                d.e_ptr = std::current_exception();
+                return -1;
+            }
+            return 0;
+        };
+        detail::Library_Lock lock;
+        detail::Profiler::Call_Timer timer((void(*)())&H5Ovisit2);
+        herr_t status = H5Ovisit2(g_id, H5_INDEX_NAME, H5_ITER_NATIVE, op, &op_data, H5O_INFO_BASIC);
+        if (op_data.e_ptr) std::rethrow_exception(op_data.e_ptr);
+        if (status < 0) throw Exception("error in H5Ovisit2");
+    } // visit_objects()
+    /**
+     * Visit the links reachable from an open group, using H5Lvisit.
+     * @param g_id HDF5 group.
+     * @param link_l Destination list of (path relative to @p g_id, link info) pairs.
+     */
+    static void
+    visit_links(hid_t g_id, std::vector< std::pair< std::string, H5L_info_t > > & link_l)
+    {
+        struct Op_Data
+        {
+            std::vector< std::pair< std::string, H5L_info_t > > * link_l_ptr;
+            std::exception_ptr e_ptr;
+        } op_data{ &link_l, nullptr };
+        auto op = [] (hid_t, char const * name, H5L_info_t const * info, void * vp) -> herr_t {
+            auto & d = *static_cast<Op_Data *>(vp);
+            try
+            {
+                d.link_l_ptr->emplace_back(name, *info);
+            }
+            catch (...)
+            {
+                d.e_ptr = std::current_exception();
+                return -1;
+            }
+            return 0;
+        };
+        detail::Library_Lock lock;
+        detail::Profiler::Call_Timer timer((void(*)())&H5Lvisit);
+        herr_t status = H5Lvisit(g_id, H5_INDEX_NAME, H5_ITER_NATIVE, op, &op_data);
+        if (op_data.e_ptr) std::rethrow_exception(op_data.e_ptr);
+        if (status < 0) throw Exception("error in H5Lvisit");
+    } // visit_links()
+
+    /// Check if the object index is enabled, and its subtree contains the given path.
+    bool
+    object_index_covers(std::string const & full_name) const
+    {
+        auto const & root = _object_index_root;
+        if (root.empty()) return false;
+        return (root == "/" or full_name == root
+                or (full_name.size() > root.size()
+                    and full_name.compare(0, root.size(), root) == 0
+                    and full_name[root.size()] == '/'));
+    } // object_index_covers()
+    /**
+     * Look up an object in the object index, loading the index if necessary.
+     * @param full_name Full path.
+     * @param type Set to the object type, or to H5O_TYPE_UNKNOWN if there is no object.
+     * @return True iff the index answers for @p full_name.
+     */
+    bool
+    object_index_lookup(std::string const & full_name, H5O_type_t & type) const
+    {
+        if (not object_index_covers(full_name)) return false;
+        if (not _object_index_loaded) load_object_index();
+        if (not _object_index_valid) return false;
+        auto it = _object_index.find(full_name);
+        type = it != _object_index.end()? it->second : H5O_TYPE_UNKNOWN;
+        return true;
+    } // object_index_lookup()
+    /// Load the object index, with one visit of the objects and one of the links under its root.
+    void
+    load_object_index() const
+    {
+        auto const & root = _object_index_root;
+        _object_index.clear();
+        _object_index_loaded = true;
+        _object_index_valid = false;
+        if (root != "/")
+        {
+            // missing root: empty index; root that is not a plain group: no index
+            if (not path_exists(split_full_name(root).first)
+                or not detail::Util::wrap(H5Lexists, _file_id, root.c_str(), H5P_DEFAULT))
+            {
+                _object_index_valid = true;
+                return;
+            }
+            if (not check_object_type(root, H5O_TYPE_GROUP)) return;
+        }
+        Exception::active_path() = root;
+        detail::HDF_Object_Holder g_id_holder(
+            detail::Util::wrap(H5Gopen2, _file_id, root.c_str(), H5P_DEFAULT),
+            detail::Util::wrapped_closer(H5Gclose));
+        std::map< haddr_t, std::pair< H5O_type_t, unsigned > > obj_m;
+        visit_objects(g_id_holder.id, obj_m);
+        std::vector< std::pair< std::string, H5L_info_t > > link_l;
+        visit_links(g_id_holder.id, link_l);
+        auto prefix = root == "/"? root : root + "/";
+        std::map< std::string, H5O_type_t > index;
+        index[root] = H5O_TYPE_GROUP;
+        for (auto const & p : link_l)
+        {
+            // H5Lvisit does not follow soft links, and it lists the members of a group once
+            if (p.second.type != H5L_TYPE_HARD) return;
+            auto it = obj_m.find(p.second.u.address);
+            if (it == obj_m.end()) return;
+            if (it->second.first == H5O_TYPE_GROUP and it->second.second > 1) return;
+            index[prefix + p.first] = it->second.first;
+        }
+        _object_index.swap(index);
+        _object_index_valid = true;
+    } // load_object_index()
+    /// Add an object, along with its ancestors under the index root, to a loaded object index.
+    void
+    object_index_insert(std::string const & full_name, H5O_type_t type) const
+    {
+        if (not _object_index_loaded or not _object_index_valid or not object_index_covers(full_name)) return;
+        _object_index[full_name] = type;
+        auto path = full_name;
+        while (path != "/")
+        {
+            path = split_full_name(path).first;
+            if (not object_index_covers(path)) break;
+            _object_index[path] = H5O_TYPE_GROUP;
+        }
+    } // object_index_insert()
+    /// Remove an object, along with its descendants, from a loaded object index.
+    void
+    object_index_erase(std::string const & full_name) const
+    {
+        if (not _object_index_loaded) return;
+        if (not object_index_covers(full_name))
+        {
+            // removing an ancestor of the root: reload on next use
+            if (_object_index_root.compare(0, full_name.size() + 1, full_name + "/") == 0)
+            {
+                _object_index_loaded = false;
+            }
+            return;
+        }
+        _object_index.erase(full_name);
+        auto prefix = full_name + "/";
+        auto it = _object_index.lower_bound(prefix);
+        while (it != _object_index.end() and it->first.compare(0, prefix.size(), prefix) == 0)
+        {
+            it = _object_index.erase(it);
+        }
+    } // object_index_erase()
 }; // class File
 
 } // namespace hdf5_tools
@@ -11,6 +11,7 @@
 /// Properties:
 /// - thread-safe, non-garbled output (uses c++11's thread_local)
 /// - customizable ostream sink. by default, uses std::clog
+/// - optional asynchronous output, for logging from hot loops in many threads
 ///
 /// Exports:
 /// - macro: LOG (takes 1, 2, or 3 arguments, see below)
@@ -53,6 +54,18 @@
 /// - By using these functions, one can set log levels using command-line
 ///   parameters and achieve dynamic log level settings without recompiling.
 ///
+/// - To write messages from a background thread instead of the logging thread:
+///
+///     logger::Logger::set_async(true);
+///     // or, with a queue of 4096 messages, dropping messages when it is full
+///     logger::Logger::set_async(true, 4096, logger::Async_Sink::drop);
+///
+///   Messages are passed through a bounded lock-free queue; when it is full, they
+///   are either dropped (and counted), or the logging thread waits for space.
+///   Messages from one thread keep their order. LOG_EXIT and LOG_ABORT flush the
+///   queue before exiting; call logger::Logger::set_async(false) to flush it and
+///   return to synchronous output.
+///
 /// - The macros LOG_EXIT_, LOG_ABORT, LOG_EXIT, LOG_THROW_, and LOG_THROW
 ///   provide a way to specify what to do after logging the message.
 ///
@@ -73,6 +86,10 @@
 #include <mutex>
 #include <stdexcept>
 #include <functional>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <memory>
 
 namespace logger
 {
@@ -88,6 +105,173 @@ enum level
     debug2
 };
 
+// Asynchronous sink: bounded lock-free multi-producer single-consumer queue of
+// messages, drained by a background thread.
+class Async_Sink
+{
+public:
+    // overflow policy: what to do with a message when the queue is full
+    enum policy
+    {
+        block = 0,
+        drop
+    };
+
+    // Constructor: allocate queue with capacity rounded up to a power of 2, start consumer.
+    Async_Sink(size_t capacity, policy overflow)
+        : _buffer(round_capacity(capacity)), _mask(_buffer.size() - 1), _overflow(overflow),
+          _enqueue_pos(0), _dequeue_pos(0), _dropped(0), _done(false)
+    {
+        for (size_t i = 0; i < _buffer.size(); ++i)
+        {
+            _buffer[i].seq.store(i, std::memory_order_relaxed);
+        }
+        _consumer = std::thread([this] () { consume(); });
+    }
+    Async_Sink(Async_Sink const &) = delete;
+    Async_Sink & operator = (Async_Sink const &) = delete;
+    // Destructor: write out pending messages, stop consumer.
+    ~Async_Sink()
+    {
+        _done = true;
+        _consumer.join();
+    }
+    // Enqueue message; return false iff it was dropped.
+    bool push(std::ostream * os_p, std::string && msg)
+    {
+        unsigned spins = 0;
+        while (not try_push(os_p, msg))
+        {
+            if (_overflow == drop)
+            {
+                ++_dropped;
+                return false;
+            }
+            backoff(spins);
+        }
+        return true;
+    }
+    // Wait until all messages enqueued so far are written out.
+    void flush()
+    {
+        size_t target = _enqueue_pos.load(std::memory_order_acquire);
+        unsigned spins = 0;
+        while (_dequeue_pos.load(std::memory_order_acquire) < target)
+        {
+            backoff(spins);
+        }
+    }
+    // Number of messages dropped so far.
+    size_t dropped() const { return _dropped.load(); }
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        std::ostream * os_p;
+        std::string msg;
+    };
+    std::vector<Cell> _buffer;
+    size_t const _mask;
+    policy const _overflow;
+    // producer and consumer positions, padded to keep them on separate cache lines
+    char _pad0[64];
+    std::atomic<size_t> _enqueue_pos;
+    char _pad1[64];
+    std::atomic<size_t> _dequeue_pos;
+    char _pad2[64];
+    std::atomic<size_t> _dropped;
+    std::atomic<bool> _done;
+    std::thread _consumer;
+
+    static size_t round_capacity(size_t capacity)
+    {
+        size_t res = 2;
+        while (res < capacity) res <<= 1;
+        return res;
+    }
+    // Spin briefly, then yield, then sleep.
+    static void backoff(unsigned & spins)
+    {
+        if (spins < 64) ++spins;
+        else if (spins < 128) { ++spins; std::this_thread::yield(); }
+        else std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    // Bounded MPMC queue of Dmitry Vyukov, used here with a single consumer.
+    bool try_push(std::ostream * os_p, std::string & msg)
+    {
+        size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+        Cell * cell_p;
+        while (true)
+        {
+            cell_p = &_buffer[pos & _mask];
+            size_t seq = cell_p->seq.load(std::memory_order_acquire);
+            if (seq == pos)
+            {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (seq < pos)
+            {
+                return false;
+            }
+            else
+            {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        cell_p->os_p = os_p;
+        cell_p->msg = std::move(msg);
+        cell_p->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    bool try_pop(std::ostream * & os_p, std::string & msg)
+    {
+        size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+        Cell & cell = _buffer[pos & _mask];
+        if (cell.seq.load(std::memory_order_acquire) != pos + 1) return false;
+        os_p = cell.os_p;
+        msg = std::move(cell.msg);
+        cell.msg.clear();
+        cell.seq.store(pos + _buffer.size(), std::memory_order_release);
+        return true;
+    }
+    void consume()
+    {
+        std::ostream * os_p = nullptr;
+        std::ostream * last_os_p = nullptr;
+        std::string msg;
+        size_t reported_dropped = 0;
+        unsigned spins = 0;
+        while (true)
+        {
+            if (try_pop(os_p, msg))
+            {
+                size_t dropped = _dropped.load();
+                if (dropped != reported_dropped)
+                {
+                    std::string note = "= logger: dropped " + std::to_string(dropped - reported_dropped) + " messages\n";
+                    os_p->write(note.c_str(), note.size());
+                    reported_dropped = dropped;
+                }
+                os_p->write(msg.c_str(), msg.size());
+                last_os_p = os_p;
+                // publish progress only after the message is written, for flush()
+                _dequeue_pos.store(_dequeue_pos.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+                spins = 0;
+            }
+            else
+            {
+                if (last_os_p)
+                {
+                    last_os_p->flush();
+                    last_os_p = nullptr;
+                }
+                if (_done and _dequeue_pos.load() == _enqueue_pos.load()) break;
+                backoff(spins);
+            }
+        }
+    }
+}; // class Async_Sink
+
 class Logger
 {
 public:
@@ -100,7 +284,15 @@ public:
         _oss << "= " << facility << "." << int(msg_level)
              << " " << file_name << ":" << line_num << " " << func_name << " ";
         _on_destruct = [&] () {
-            _os_p->write(_oss.str().c_str(), _oss.str().size());
+            Async_Sink * sink_p = async_sink().load(std::memory_order_acquire);
+            if (sink_p)
+            {
+                sink_p->push(_os_p, _oss.str());
+            }
+            else
+            {
+                _os_p->write(_oss.str().c_str(), _oss.str().size());
+            }
         };
     }
     // Constructor for exiting
@@ -111,6 +303,11 @@ public:
     {
         _oss << file_name << ":" << line_num << " " << func_name << " ";
         _on_destruct = [&] () {
+            Async_Sink * sink_p = async_sink().load(std::memory_order_acquire);
+            if (sink_p)
+            {
+                sink_p->flush();
+            }
             _os_p->write(_oss.str().c_str(), _oss.str().size());
             if (_exit_code < 0)
             {
@@ -210,6 +407,40 @@ public:
             set_level_from_option(l, os_p);
         }
     }
+    // static methods for asynchronous output
+    // If enabling, messages are passed to a new sink with the given queue capacity and overflow policy;
+    // if disabling, pending messages are written out before returning.
+    // Sinks are retired rather than destroyed, so that concurrent loggers never see a dangling sink;
+    // they are destroyed at exit, after writing out any pending messages.
+    static void set_async(bool enable, size_t capacity = 1024, Async_Sink::policy overflow = Async_Sink::block)
+    {
+        // construct the sink pointer first, so that it outlives the sink list
+        std::atomic<Async_Sink *> & current_sink = async_sink();
+        struct Sink_List
+        {
+            std::vector<std::unique_ptr<Async_Sink>> l;
+            // at exit, return to synchronous output, then destroy sinks
+            ~Sink_List() { async_sink() = nullptr; }
+        };
+        static Sink_List sinks;
+        static std::mutex m;
+        std::lock_guard<std::mutex> lg(m);
+        Async_Sink * new_sink_p = nullptr;
+        if (enable)
+        {
+            sinks.l.emplace_back(new Async_Sink(capacity, overflow));
+            new_sink_p = sinks.l.back().get();
+        }
+        Async_Sink * old_sink_p = current_sink.exchange(new_sink_p);
+        if (old_sink_p)
+        {
+            old_sink_p->flush();
+        }
+    }
+    static bool get_async()
+    {
+        return async_sink().load() != nullptr;
+    }
     // public static utility functions (used by LOG macro)
     static level get_level(level l) { return l; }
     static level get_level(int i) { return static_cast<level>(i); }
@@ -227,6 +458,11 @@ private:
     int _exit_code;
 
     // private static data members
+    static std::atomic<Async_Sink *> & async_sink()
+    {
+        static std::atomic<Async_Sink *> _async_sink(nullptr);
+        return _async_sink;
+    }
     static level & default_level()
     {
         static level _default_level = error;